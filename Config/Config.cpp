@@ -93,6 +93,15 @@ public:
         cfg.m_logTimeStamp = item.value("m_logTimeStamp", true);
         cfg.m_checkSample = item.value("m_checkSample", false);
         cfg.m_delayMode = item.value("m_delayMode", 0);
+        cfg.m_sizeMode = item.value("m_sizeMode", DEFAULT_SIZE_MODE);
+        cfg.m_sizeFile = item.value("m_sizeFile", "");
+        cfg.m_sizeStep = item.value("m_sizeStep", 0);
+        cfg.m_sampleRingSize = item.value("m_sampleRingSize", 0);
+        cfg.m_zeroCopyPoolSize = item.value("m_zeroCopyPoolSize", 0);
+        cfg.m_logOverflow = item.value("m_logOverflow", "block");
+        cfg.m_logLevel = item.value("m_logLevel", "info");
+        cfg.m_perfCounters = item.value("m_perfCounters", false);
+        cfg.m_netInterface = item.value("m_netInterface", "");
         
 
         auto load_vector = [&](const std::string& key, std::vector<int>& vec, bool& has) {
@@ -287,6 +296,15 @@ public:
         out << "\tm_logTimeStamp:\t" << c.m_logTimeStamp << std::endl;
         out << "\tm_checkSample:\t" << c.m_checkSample << std::endl;
         out << "\tm_delayMode:\t" << c.m_delayMode << std::endl;
+        out << "\tm_sizeMode:\t" << c.m_sizeMode << std::endl;
+        out << "\tm_sizeStep:\t" << c.m_sizeStep << std::endl;
+        out << "\tm_sizeFile:\t" << c.m_sizeFile << std::endl;
+        out << "\tm_sampleRingSize:\t" << c.m_sampleRingSize << std::endl;
+        out << "\tm_zeroCopyPoolSize:\t" << c.m_zeroCopyPoolSize << std::endl;
+        out << "\tm_logOverflow:\t" << c.m_logOverflow << std::endl;
+        out << "\tm_logLevel:\t" << c.m_logLevel << std::endl;
+        out << "\tm_perfCounters:\t" << c.m_perfCounters << std::endl;
+        out << "\tm_netInterface:\t" << c.m_netInterface << std::endl;
         out << "\tm_activeLoop:\t" << c.m_activeLoop << std::endl;
         out << "\tm_loopNum:\t" << c.m_loopNum << std::endl;
 
@@ -326,6 +344,7 @@ public:
 
     static constexpr const char* DEFAULT_LATENCY_MODE = "pp";
     static constexpr const char* DEFAULT_CLOCK_DEV_NAME = "CLOCK_REALTIME";
+    static constexpr const char* DEFAULT_SIZE_MODE = "fixed";
 };
 
 // ============= Config 接口实现 =============
@@ -491,6 +510,15 @@ void Config::printConfigToStream(const ConfigData& c, std::ostream& out) {
     out << "\tm_logTimeStamp:\t" << (c.m_logTimeStamp ? "true" : "false") << std::endl;
     out << "\tm_checkSample:\t" << (c.m_checkSample ? "true" : "false") << std::endl;
     out << "\tm_delayMode:\t" << c.m_delayMode << std::endl;
+    out << "\tm_sizeMode:\t" << c.m_sizeMode << std::endl;
+    out << "\tm_sizeStep:\t" << c.m_sizeStep << std::endl;
+    out << "\tm_sizeFile:\t" << c.m_sizeFile << std::endl;
+    out << "\tm_sampleRingSize:\t" << c.m_sampleRingSize << std::endl;
+    out << "\tm_zeroCopyPoolSize:\t" << c.m_zeroCopyPoolSize << std::endl;
+    out << "\tm_logOverflow:\t" << c.m_logOverflow << std::endl;
+    out << "\tm_logLevel:\t" << c.m_logLevel << std::endl;
+    out << "\tm_perfCounters:\t" << (c.m_perfCounters ? "true" : "false") << std::endl;
+    out << "\tm_netInterface:\t" << c.m_netInterface << std::endl;
     out << "\tm_activeLoop:\t" << c.m_activeLoop << std::endl;
     out << "\tm_loopNum:\t" << c.m_loopNum << std::endl;
 
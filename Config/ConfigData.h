@@ -19,6 +19,30 @@ struct ConfigData {
     std::string m_latencyMode;
     std::string m_resultPath;
 
+    // 䳤 payloadfixed / uniform / sweep / file PayloadSchedule
+    std::string m_sizeMode;
+    std::string m_sizeFile;
+    int m_sizeStep;
+
+    // Bytes 0 =  buffer ã< 0 =  DataWriter resource_limits 㣬> 0 = ָ
+    int m_sampleRingSize;
+
+    // ZeroCopyBytes ͻشС0 =  buffer ã< 0 =  DataWriter history / resource_limits 㣬
+    // > 0 = ָдʷ + 1 ʱԶ㣩
+    int m_zeroCopyPoolSize;
+
+    // ־ʱĲԣ"block" = ȴд̣߳Ĭϣ־"drop" = ̣߳
+    std::string m_logOverflow;
+
+    // ־"trace" / "debug" / "info"Ĭϣ/ "warn" / "error" / "off"ֻ LOG_xxx 
+    std::string m_logLevel;
+
+    // Ƿ perf_event_open ͳƷѭ / Listener ص̵߳Ӳ LinuxȨʱԶ
+    bool m_perfCounters;
+
+    // ͳƵգĬϣʾȫ up ״̬
+    std::string m_netInterface;
+
     int m_activeLoop;
     int m_delayMode;
     int m_domainId;
@@ -2,6 +2,7 @@
 #include "DDSManager_Bytes.h"
 #include "Logger.h"
 #include "GloMemPool.h"
+#include "RoundArena.h"
 
 #include "ZRDDSDataReader.h"
 #include "ZRDDSTypeSupport.h"
@@ -12,6 +13,7 @@
 #include <sstream>
 #include <random>
 #include <chrono>
+#include <algorithm>
 
 // Packet Header 结构（定义在 .cpp 内部即可）
 struct PacketHeader {
@@ -20,6 +22,13 @@ struct PacketHeader {
     uint8_t  packet_type;
 };
 
+namespace {
+    // 样本环推算参数：resource_limits 不限时的默认槽数、槽数上限、整环内存上限
+    constexpr int DEFAULT_RING_SLOTS = 64;
+    constexpr int MAX_RING_SLOTS = 4096;
+    constexpr size_t MAX_RING_BYTES = 256u * 1024u * 1024u;
+}
+
 // 内部 Listener 类 - 使用 Bytes 类型
 class DDSManager_Bytes::MyDataReaderListener
     : public virtual DDS::SimpleDataReaderListener<DDS::Bytes, DDS::BytesSeq, DDS::ZRDDSDataReader<DDS::Bytes, DDS::BytesSeq>>
@@ -37,7 +46,7 @@ public:
         const DDS::SampleInfo& info
     ) override {
         if (!info.valid_data || sample.value.length() < sizeof(PacketHeader)) {
-            Logger::getInstance().logAndPrint("[DDSManager_Bytes] 收到无效或过短的数据包");
+            LOG_WARN("[DDSManager_Bytes] 收到无效或过短的数据包");
             return;
         }
 
@@ -152,20 +161,46 @@ bool DDSManager_Bytes::initialize(
         return false;
     }
 
-    // 创建 Writer 或 Reader
-    if (role_ == "publisher") {
+    // ping-pong 模式：额外创建回显 Topic（同一类型，名称加 _echo 后缀）
+    if (echo_mode_) {
+        const std::string echo_topic_name = topic_name_ + "_echo";
+        echo_topic_ = participant_->create_topic(
+            echo_topic_name.c_str(), registered_type_name,
+            DDS::TOPIC_QOS_DEFAULT, nullptr, DDS::STATUS_MASK_NONE);
+        if (!echo_topic_) {
+            Logger::getInstance().error("[DDSManager_Bytes] 创建回显 Topic '" + echo_topic_name + "' 失败");
+            return false;
+        }
+    }
+
+    if (role_ != "publisher" && role_ != "subscriber") {
+        Logger::getInstance().error("[DDSManager_Bytes] 无效角色: " + role_);
+        return false;
+    }
+
+    // 创建 Writer 和/或 Reader
+    // 普通模式下只创建本角色的实体；回显模式下两侧都需要 Writer + Reader，
+    // 接收端先建回显 Writer，保证第一条数据到达时即可回写
+    const bool need_writer = (role_ == "publisher") || echo_mode_;
+    const bool need_reader = (role_ == "subscriber") || echo_mode_;
+
+    if (need_writer) {
+        DDS::Topic* writer_topic = (role_ == "publisher") ? topic_ : echo_topic_;
         data_writer_ = participant_->create_datawriter_with_topic_and_qos_profile(
-            topic_->get_name(), type_support,
+            writer_topic->get_name(), type_support,
             "default_lib", "default_profile", data_writer_qos_name_.c_str(),
             nullptr, DDS::STATUS_MASK_NONE);
         if (!data_writer_) {
             Logger::getInstance().error("[DDSManager_Bytes] 创建 DataWriter 失败");
             return false;
         }
-        Logger::getInstance().logAndPrint("[DDSManager_Bytes] DataWriter 创建成功");
+        Logger::getInstance().logAndPrint(std::string("[DDSManager_Bytes] DataWriter 创建成功 | topic=") + writer_topic->get_name());
     }
-    else if (role_ == "subscriber") {
-        void* mem = GloMemPool::allocate(sizeof(MyDataReaderListener), __FILE__, __LINE__);
+
+    if (need_reader) {
+        DDS::Topic* reader_topic = (role_ == "subscriber") ? topic_ : echo_topic_;
+        // 监听器只在本轮内有效，放在轮次 arena 中，shutdown 只析构不释放
+        void* mem = RoundArena::instance().allocate(sizeof(MyDataReaderListener), alignof(MyDataReaderListener));
         if (!mem) {
             Logger::getInstance().error("[DDSManager_Bytes] 分配监听器内存失败");
             return false;
@@ -173,21 +208,16 @@ bool DDSManager_Bytes::initialize(
         listener_ = new (mem) MyDataReaderListener(std::move(dataCallback), std::move(endCallback));
 
         data_reader_ = participant_->create_datareader_with_topic_and_qos_profile(
-            topic_->get_name(), type_support,
+            reader_topic->get_name(), type_support,
             "default_lib", "default_profile", data_reader_qos_name_.c_str(),
             listener_, DDS::STATUS_MASK_ALL);
         if (!data_reader_) {
             listener_->~MyDataReaderListener();
-            GloMemPool::deallocate(listener_);
             listener_ = nullptr;
             Logger::getInstance().error("[DDSManager_Bytes] 创建 DataReader 失败");
             return false;
         }
-        Logger::getInstance().logAndPrint("[DDSManager_Bytes] DataReader 创建成功");
-    }
-    else {
-        Logger::getInstance().error("[DDSManager_Bytes] 无效角色: " + role_);
-        return false;
+        Logger::getInstance().logAndPrint(std::string("[DDSManager_Bytes] DataReader 创建成功 | topic=") + reader_topic->get_name());
     }
 
     is_initialized_ = true;
@@ -200,7 +230,6 @@ void DDSManager_Bytes::shutdown() {
 
     if (listener_) {
         static_cast<MyDataReaderListener*>(listener_)->~MyDataReaderListener();
-        GloMemPool::deallocate(listener_);
         listener_ = nullptr;
     }
 
@@ -209,10 +238,14 @@ void DDSManager_Bytes::shutdown() {
         factory_->delete_participant(participant_);
         participant_ = nullptr;
         topic_ = nullptr;
+        echo_topic_ = nullptr;
         data_writer_ = nullptr;
         data_reader_ = nullptr;
     }
 
+    // 实体删除后 Writer 不再引用环中的样本（确认超时的一轮会保留到这里）
+    cleanupBytesRing();
+
     is_initialized_ = false;
     Logger::getInstance().logAndPrint("[DDSManager_Bytes] 已关闭");
 }
@@ -273,12 +306,12 @@ bool DDSManager_Bytes::prepareBytesData(
 
     sample.value._length = ul_size;
 
-    std::ostringstream oss;
-    oss << "prepareBytesData: seq=" << sequence
-        << " ts=" << timestamp
-        << " type=" << static_cast<int>(hdr->packet_type)
-        << " length=" << ul_size;
-    Logger::getInstance().logAndPrint(oss.str());
+    LOG_TRACE(
+        "prepareBytesData: seq=" + std::to_string(sequence) +
+        " ts=" + std::to_string(timestamp) +
+        " type=" + std::to_string(static_cast<int>(hdr->packet_type)) +
+        " length=" + std::to_string(ul_size)
+    );
 
     return true;
 }
@@ -335,4 +368,74 @@ bool DDSManager_Bytes::prepareEndBytesData(DDS::Bytes& sample, int minSize) {
     );
 
     return true;
+}
+
+// 根据 DataWriter 的 resource_limits 推算样本环槽数
+int DDSManager_Bytes::resolveRingSlots(int requested, int size) const {
+    int slots = requested;
+    if (slots <= 0) {
+        slots = DEFAULT_RING_SLOTS;
+        DDS::DataWriterQos qos;
+        if (data_writer_ && data_writer_->get_qos(qos) == DDS::RETCODE_OK &&
+            qos.resource_limits.max_samples > 0) {
+            // Writer 最多同时持有 max_samples 个样本，环再大也不会被引用到
+            slots = qos.resource_limits.max_samples;
+        }
+    }
+
+    const size_t per_slot = static_cast<size_t>(std::max(size, 1));
+    const int memory_cap = static_cast<int>(std::max<size_t>(1, MAX_RING_BYTES / per_slot));
+    return std::min({ slots, MAX_RING_SLOTS, memory_cap });
+}
+
+bool DDSManager_Bytes::prepareBytesRing(int slots, int size) {
+    cleanupBytesRing();
+
+    const size_t header_size = sizeof(PacketHeader);
+    DDS_ULong ul_size = static_cast<DDS_ULong>(std::max<size_t>(static_cast<size_t>(std::max(size, 0)), header_size));
+    const DDS_ULong reserve_extra = (ul_size > 65536) ? 256 : (ul_size > 4096) ? 64 : 16;
+    const DDS_ULong alloc_size = ul_size + reserve_extra;
+
+    const int count = resolveRingSlots(slots, static_cast<int>(alloc_size));
+    sample_ring_.resize(static_cast<size_t>(count));
+
+    for (int k = 0; k < count; ++k) {
+        DDS::Bytes& sample = sample_ring_[k];
+        DDS_OctetSeq_initialize(&sample.value);
+
+        DDS_Octet* buffer = static_cast<DDS_Octet*>(
+            GloMemPool::allocate(alloc_size * sizeof(DDS_Octet), __FILE__, __LINE__)
+            );
+        if (!buffer || !DDS_OctetSeq_loan_contiguous(&sample.value, buffer, ul_size, alloc_size)) {
+            GloMemPool::deallocate(buffer);
+            sample_ring_.resize(static_cast<size_t>(k));
+            cleanupBytesRing();
+            Logger::getInstance().error("[DDSManager_Bytes] 样本环第 " + std::to_string(k) + " 槽分配失败");
+            return false;
+        }
+
+        PacketHeader* hdr = reinterpret_cast<PacketHeader*>(buffer);
+        hdr->sequence = 0;
+        hdr->timestamp = 0;
+        hdr->packet_type = 0;
+        for (DDS_ULong i = header_size; i < ul_size; ++i) {
+            buffer[i] = static_cast<DDS_Octet>((i + k) % 255);
+        }
+    }
+
+    Logger::getInstance().logAndPrint(
+        "[DDSManager_Bytes] 样本环已就绪: " + std::to_string(count) + " 槽 x " +
+        std::to_string(ul_size) + " 字节"
+    );
+    return true;
+}
+
+void DDSManager_Bytes::cleanupBytesRing() {
+    for (auto& sample : sample_ring_) {
+        DDS_Octet* buffer = sample.value.get_contiguous_buffer();
+        DDS_OctetSeq_unloan(&sample.value);
+        DDS_OctetSeq_finalize(&sample.value);
+        GloMemPool::deallocate(buffer);
+    }
+    sample_ring_.clear();
 }
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 class DDSManager_Bytes {
 public:
@@ -29,6 +30,10 @@ public:
 
     void shutdown();
 
+    // ping-pong 时延测试：发送端写 topic、读 topic_echo，接收端反之（须在 initialize 前调用）
+    void setEchoMode(bool enable) { echo_mode_ = enable; }
+    bool isEchoMode() const { return echo_mode_; }
+
     // 获取实体指针
     DDS::DataWriter* get_data_writer() const { return data_writer_; }
     DDS::DataReader* get_data_reader() const { return data_reader_; }
@@ -46,6 +51,13 @@ public:
     // 清理 Bytes 数据
     void cleanupBytesData(DDS::Bytes& sample);
 
+    // 预租借样本环：slots 个互不别名的 buffer（slots <= 0 时按 DataWriter resource_limits 推算），
+    // 发送循环轮流使用，模拟中间件按引用排队（ASYNC / batch）时的真实内存访问
+    bool prepareBytesRing(int slots, int size);
+    DDS::Bytes& ringSample(size_t index) { return sample_ring_[index % sample_ring_.size()]; }
+    size_t ringSize() const { return sample_ring_.size(); }
+    void cleanupBytesRing();
+
 private:
     // 配置参数
     int domain_id_;
@@ -62,13 +74,16 @@ private:
     DDS::DomainParticipantFactory* factory_ = nullptr;
     DDS::DomainParticipant* participant_ = nullptr;
     DDS::Topic* topic_ = nullptr;
+    DDS::Topic* echo_topic_ = nullptr;
     DDS::DataWriter* data_writer_ = nullptr;
     DDS::DataReader* data_reader_ = nullptr;
     class MyDataReaderListener;
     MyDataReaderListener* listener_ = nullptr;
 
-    bool is_initialized_ = false;
+    std::vector<DDS::Bytes> sample_ring_;
 
-    // 内部 Listener 类声明
-    class MyDataReaderListener;
+    int resolveRingSlots(int requested, int size) const;
+
+    bool is_initialized_ = false;
+    bool echo_mode_ = false;
 };
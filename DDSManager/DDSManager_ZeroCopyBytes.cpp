@@ -2,13 +2,14 @@
 #include "DDSManager_ZeroCopyBytes.h"
 #include "Logger.h"
 #include "GloMemPool.h"
+#include "RoundArena.h"
 
 #include "ZRDDSDataReader.h"
 #include "ZRDDSTypeSupport.h"
 #include "ZRBuiltinTypesTypeSupport.h"
 #include "ZRDDSDataWriter.h"
 
-#include <iostream>
+#include <algorithm>
 #include <sstream>
 #include <random>
 #include <chrono>
@@ -42,7 +43,7 @@ public:
         const DDS::SampleInfo& info
     ) override {
         if (!info.valid_data || sample.userLength < sizeof(PacketHeader)) {
-            Logger::getInstance().logAndPrint("[DDSManager_ZeroCopyBytes] Invalid or short packet.");
+            LOG_WARN("[DDSManager_ZeroCopyBytes] Invalid or short packet.");
             return;
         }
 
@@ -96,7 +97,7 @@ bool DDSManager_ZeroCopyBytes::initialize(
     OnDataReceivedCallback_ZC dataCallback,
     OnEndOfRoundCallback endCallback
 ) {
-    std::cout << "[DDSManager_ZeroCopyBytes] Initializing DDS entities...\n";
+    LOG_INFO("[DDSManager_ZeroCopyBytes] Initializing DDS entities...");
 
     const char* qosFilePath = xml_qos_file_path_.c_str();
     const char* p_lib_name = "default_lib";
@@ -108,7 +109,7 @@ bool DDSManager_ZeroCopyBytes::initialize(
     factory_ = DDS::DomainParticipantFactory::get_instance_w_profile(
         qosFilePath, p_lib_name, p_prof_name, pf_qos_name);
     if (!factory_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to get DomainParticipantFactory.\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] Failed to get DomainParticipantFactory");
         return false;
     }
 
@@ -116,25 +117,25 @@ bool DDSManager_ZeroCopyBytes::initialize(
     participant_ = factory_->create_participant_with_qos_profile(
         domain_id_, p_lib_name, p_prof_name, p_qos_name, nullptr, DDS::STATUS_MASK_NONE);
     if (!participant_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create DomainParticipant.\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] Failed to create DomainParticipant");
         return false;
     }
 
     // ע - ʹ ZeroCopyBytes TypeSupport
     DDS::ZeroCopyBytesTypeSupport* type_support = DDS::ZeroCopyBytesTypeSupport::get_instance();
     if (!type_support) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to get ZeroCopyBytesTypeSupport instance.\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] Failed to get ZeroCopyBytesTypeSupport instance");
         return false;
     }
 
     const char* registered_type_name = type_support->get_type_name();
     if (!registered_type_name || strlen(registered_type_name) == 0) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Type name is null or empty.\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] Type name is null or empty");
         return false;
     }
 
     if (type_support->register_type(participant_, registered_type_name) != DDS::RETCODE_OK) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to register type '" << registered_type_name << "'.\n";
+        LOG_ERROR(std::string("[DDSManager_ZeroCopyBytes] Failed to register type '") + registered_type_name + "'");
         return false;
     }
 
@@ -143,7 +144,7 @@ bool DDSManager_ZeroCopyBytes::initialize(
         topic_name_.c_str(), registered_type_name,
         DDS::TOPIC_QOS_DEFAULT, nullptr, DDS::STATUS_MASK_NONE);
     if (!topic_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create Topic '" << topic_name_ << "'.\n";
+        LOG_ERROR(std::string("[DDSManager_ZeroCopyBytes] Failed to create Topic '") + topic_name_ + "'");
         return false;
     }
 
@@ -151,59 +152,81 @@ bool DDSManager_ZeroCopyBytes::initialize(
     size_t totalBufferSize = max_possible_size_ + DEFAULT_HEADER_RESERVE;
     global_buffer_ = static_cast<char*>(GloMemPool::allocate(totalBufferSize, __FILE__, __LINE__));
     if (!global_buffer_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to allocate global buffer for zero-copy.\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] Failed to allocate global buffer for zero-copy");
         return false;
     }
-    std::cout << "[DDSManager_ZeroCopyBytes] Allocated global zero-copy buffer of size: " << totalBufferSize << " bytes\n";
+    LOG_INFO(std::string("[DDSManager_ZeroCopyBytes] Allocated global zero-copy buffer of size: ") + std::to_string(totalBufferSize) + " bytes");
+
+    // ping-pong ģʽⴴ TopicͬһͣƼ _echo ׺
+    if (echo_mode_) {
+        const std::string echo_topic_name = topic_name_ + "_echo";
+        echo_topic_ = participant_->create_topic(
+            echo_topic_name.c_str(), registered_type_name,
+            DDS::TOPIC_QOS_DEFAULT, nullptr, DDS::STATUS_MASK_NONE);
+        if (!echo_topic_) {
+            GloMemPool::deallocate(global_buffer_);
+            global_buffer_ = nullptr;
+            LOG_ERROR(std::string("[DDSManager_ZeroCopyBytes] Failed to create echo Topic '") + echo_topic_name + "'");
+            return false;
+        }
+    }
+
+    if (role_ != "publisher" && role_ != "subscriber") {
+        LOG_ERROR(std::string("[DDSManager_ZeroCopyBytes] Invalid role: ") + role_);
+        GloMemPool::deallocate(global_buffer_);
+        global_buffer_ = nullptr;
+        return false;
+    }
+
+    //  Writer / Reader
+    // ͨģʽֻɫʵ壻ģʽ඼Ҫ Writer + Reader
+    const bool need_writer = (role_ == "publisher") || echo_mode_;
+    const bool need_reader = (role_ == "subscriber") || echo_mode_;
 
-    //  Writer  Reader
-    if (role_ == "publisher") {
+    if (need_writer) {
+        DDS::Topic* writer_topic = (role_ == "publisher") ? topic_ : echo_topic_;
         data_writer_ = participant_->create_datawriter_with_topic_and_qos_profile(
-            topic_->get_name(), type_support,
+            writer_topic->get_name(), type_support,
             "default_lib", "default_profile", data_writer_qos_name_.c_str(),
             nullptr, DDS::STATUS_MASK_NONE);
         if (!data_writer_) {
             GloMemPool::deallocate(global_buffer_);
             global_buffer_ = nullptr;
-            std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create DataWriter.\n";
+            LOG_ERROR("[DDSManager_ZeroCopyBytes] Failed to create DataWriter");
             return false;
         }
-        std::cout << "[DDSManager_ZeroCopyBytes] Created DataWriter.\n";
+        LOG_INFO(std::string("[DDSManager_ZeroCopyBytes] Created DataWriter on topic ") + writer_topic->get_name());
     }
-    else if (role_ == "subscriber") {
-        void* mem = GloMemPool::allocate(sizeof(MyDataReaderListener), __FILE__, __LINE__);
+
+    if (need_reader) {
+        DDS::Topic* reader_topic = (role_ == "subscriber") ? topic_ : echo_topic_;
+        // ֻڱЧִ arena Уshutdown ֻͷ
+        void* mem = RoundArena::instance().allocate(sizeof(MyDataReaderListener), alignof(MyDataReaderListener));
         if (!mem) {
             GloMemPool::deallocate(global_buffer_);
             global_buffer_ = nullptr;
-            std::cerr << "[DDSManager_ZeroCopyBytes] Memory allocation failed for listener.\n";
+            LOG_ERROR("[DDSManager_ZeroCopyBytes] Memory allocation failed for listener");
             return false;
         }
         listener_ = new (mem) MyDataReaderListener(std::move(dataCallback), std::move(endCallback));
 
         data_reader_ = participant_->create_datareader_with_topic_and_qos_profile(
-            topic_->get_name(), type_support,
+            reader_topic->get_name(), type_support,
             "default_lib", "default_profile", data_reader_qos_name_.c_str(),
             listener_, DDS::DATA_AVAILABLE_STATUS);
         if (!data_reader_) {
             listener_->~MyDataReaderListener();
-            GloMemPool::deallocate(listener_);
             listener_ = nullptr;
             GloMemPool::deallocate(global_buffer_);
             global_buffer_ = nullptr;
-            std::cerr << "[DDSManager_ZeroCopyBytes] Failed to create DataReader.\n";
+            LOG_ERROR("[DDSManager_ZeroCopyBytes] Failed to create DataReader");
             return false;
         }
-        std::cout << "[DDSManager_ZeroCopyBytes] Created DataReader with listener.\n";
-    }
-    else {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Invalid role: " << role_ << "\n";
-        GloMemPool::deallocate(global_buffer_);
-        global_buffer_ = nullptr;
-        return false;
+        LOG_INFO(std::string("[DDSManager_ZeroCopyBytes] Created DataReader with listener on topic ") + reader_topic->get_name());
     }
 
     is_initialized_ = true;
-    std::cout << "[DDSManager_ZeroCopyBytes] Initialization successful.\n";
+    LOG_INFO("[DDSManager_ZeroCopyBytes] Initialization successful");
     return true;
 }
 
@@ -212,26 +235,28 @@ void DDSManager_ZeroCopyBytes::shutdown() {
 
     if (listener_) {
         listener_->~MyDataReaderListener();
-        GloMemPool::deallocate(listener_);
         listener_ = nullptr;
     }
 
-    if (global_buffer_) {
-        GloMemPool::deallocate(global_buffer_);
-        global_buffer_ = nullptr;
-    }
-
     if (participant_) {
         participant_->delete_contained_entities();
         factory_->delete_participant(participant_);
         participant_ = nullptr;
         topic_ = nullptr;
+        echo_topic_ = nullptr;
         data_writer_ = nullptr;
         data_reader_ = nullptr;
     }
 
+    // ʵɾм㿽 bufferȷϳʱһֻᱣ
+    if (global_buffer_) {
+        GloMemPool::deallocate(global_buffer_);
+        global_buffer_ = nullptr;
+    }
+    cleanupBufferPool();
+
     is_initialized_ = false;
-    std::cout << "[DDSManager_ZeroCopyBytes] Shutdown completed.\n";
+    LOG_INFO("[DDSManager_ZeroCopyBytes] Shutdown completed");
 }
 
 // DDSManager_ZeroCopyBytes.cpp
@@ -252,7 +277,7 @@ bool DDSManager_ZeroCopyBytes::ensureBufferSize(size_t user_data_size) {
     //  buffer
     global_buffer_ = static_cast<char*>(GloMemPool::allocate(required_total, __FILE__, __LINE__));
     if (!global_buffer_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Failed to allocate buffer for size: " << required_total << "\n";
+        LOG_ERROR(std::string("[DDSManager_ZeroCopyBytes] Failed to allocate buffer for size: ") + std::to_string(required_total));
         max_possible_size_ = 0;
         return false;
     }
@@ -270,7 +295,7 @@ bool DDSManager_ZeroCopyBytes::ensureBufferSize(size_t user_data_size) {
 // ׼ (ZeroCopy 汾)
 bool DDSManager_ZeroCopyBytes::prepareZeroCopyData(DDS_ZeroCopyBytes& sample, int dataSize, uint32_t sequence) {
     if (!global_buffer_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Global buffer not allocated. Call initialize first!\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] Global buffer not allocated. Call initialize first!");
         return false;
     }
 
@@ -280,8 +305,8 @@ bool DDSManager_ZeroCopyBytes::prepareZeroCopyData(DDS_ZeroCopyBytes& sample, in
     }
 
     if (static_cast<size_t>(dataSize) > max_possible_size_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Data size (" << dataSize
-            << ") exceeds maximum possible size (" << max_possible_size_ << ").\n";
+        LOG_ERROR(std::string("[DDSManager_ZeroCopyBytes] Data size (") + std::to_string(dataSize) +
+            ") exceeds maximum possible size (" + std::to_string(max_possible_size_) + ")");
         return false;
     }
 
@@ -305,7 +330,7 @@ bool DDSManager_ZeroCopyBytes::prepareZeroCopyData(DDS_ZeroCopyBytes& sample, in
         sample.userBuffer[i] = static_cast<DDS::Octet>((i + sequence) % 255);
     }
 
-    Logger::getInstance().logAndPrint(
+    LOG_TRACE(
         "prepareZeroCopyData: seq=" + std::to_string(sequence) +
         " userLength=" + std::to_string(sample.userLength) +
         " reservedLength=" + std::to_string(DEFAULT_HEADER_RESERVE) +
@@ -318,7 +343,7 @@ bool DDSManager_ZeroCopyBytes::prepareZeroCopyData(DDS_ZeroCopyBytes& sample, in
 // ׼ͳһʽ
 bool DDSManager_ZeroCopyBytes::prepareEndZeroCopyData(DDS_ZeroCopyBytes& sample) {
     if (!global_buffer_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] Global buffer not allocated.\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] Global buffer not allocated");
         return false;
     }
 
@@ -326,7 +351,7 @@ bool DDSManager_ZeroCopyBytes::prepareEndZeroCopyData(DDS_ZeroCopyBytes& sample)
     const size_t dataSize = headerSize;
 
     if (dataSize > max_possible_size_) {
-        std::cerr << "[DDSManager_ZeroCopyBytes] End packet size exceeds limit.\n";
+        LOG_ERROR("[DDSManager_ZeroCopyBytes] End packet size exceeds limit");
         return false;
     }
 
@@ -350,4 +375,164 @@ bool DDSManager_ZeroCopyBytes::prepareEndZeroCopyData(DDS_ZeroCopyBytes& sample)
     );
 
     return true;
+}
+
+//  buffer ͳ
+bool DDSManager_ZeroCopyBytes::prepareBufferPool(int slots, size_t user_data_size) {
+    cleanupBufferPool();
+
+    const size_t user_size = std::max(user_data_size, sizeof(PacketHeader));
+
+    pool_reliable_ = false;
+    writer_depth_ = 0;
+    int count = slots;
+    DDS::DataWriterQos qos;
+    if (data_writer_ && data_writer_->get_qos(qos) == DDS::RETCODE_OK) {
+        pool_reliable_ = (qos.reliability.kind == DDS::RELIABLE_RELIABILITY_QOS);
+        // Writer ʷ writer_depth_ KEEP_LAST дһ滻
+        // KEEP_ALL ʷʱ write ȷƳϵ buffer ѱͷ
+        const int max_samples = qos.resource_limits.max_samples;
+        if (qos.history.kind == DDS::KEEP_LAST_HISTORY_QOS && qos.history.depth > 0) {
+            writer_depth_ = max_samples > 0 ? std::min(qos.history.depth, max_samples) : qos.history.depth;
+        }
+        else if (qos.history.kind == DDS::KEEP_ALL_HISTORY_QOS && max_samples > 0) {
+            writer_depth_ = max_samples;
+        }
+    }
+    if (count <= 0) {
+        count = writer_depth_ > 0 ? writer_depth_ + 1 : DEFAULT_POOL_SLOTS;
+    }
+    else if (writer_depth_ > 0 && count <= writer_depth_) {
+        Logger::getInstance().logAndPrint(
+            "[DDSManager_ZeroCopyBytes]  " + std::to_string(count) + " Ըдʷ " +
+            std::to_string(writer_depth_) + "Ϊ " + std::to_string(writer_depth_ + 1) + " "
+        );
+        count = writer_depth_ + 1;
+    }
+    const size_t per_slot = user_size + DEFAULT_HEADER_RESERVE;
+    const int memory_cap = static_cast<int>(std::max<size_t>(1, MAX_POOL_BYTES / per_slot));
+    count = std::min({ count, MAX_POOL_SLOTS, memory_cap });
+    if (writer_depth_ > 0 && count <= writer_depth_) {
+        // Ųʷʱ޷滻գ˻سغľʱȴȷ
+        Logger::getInstance().logAndPrint(
+            "[DDSManager_ZeroCopyBytes] дʷ " + std::to_string(writer_depth_) +
+            "  " + std::to_string(count) + "Ϊغľʱȴȷϻ"
+        );
+        writer_depth_ = 0;
+    }
+
+    if (!buffer_pool_.create(count, DEFAULT_HEADER_RESERVE, user_size)) {
+        Logger::getInstance().error("[DDSManager_ZeroCopyBytes] 㿽طʧ: " + std::to_string(count) + " ");
+        return false;
+    }
+
+    // payload ģʽֻһΣʱд header
+    const size_t header_size = sizeof(PacketHeader);
+    for (size_t k = 0; k < buffer_pool_.slots(); ++k) {
+        char* user = buffer_pool_.buffer(k) + DEFAULT_HEADER_RESERVE;
+        memset(user, 0, header_size);
+        for (size_t i = header_size; i < user_size; ++i) {
+            user[i] = static_cast<char>((i + k) % 255);
+        }
+    }
+
+    Logger::getInstance().logAndPrint(
+        "[DDSManager_ZeroCopyBytes] 㿽Ѿ: " + std::to_string(count) + "  x " +
+        std::to_string(buffer_pool_.bufferBytes()) + " ֽ, շʽ=" +
+        (writer_depth_ > 0 ? "ʷ滻 ( " + std::to_string(writer_depth_) + ")"
+            : pool_reliable_ ? std::string("غľʱȷϺ") : std::string("գ踲"))
+    );
+    return true;
+}
+
+bool DDSManager_ZeroCopyBytes::acquirePooledSample(DDS_ZeroCopyBytes& sample, int dataSize, uint32_t sequence) {
+    int index = buffer_pool_.acquire();
+    if (index < 0) {
+        // ֻдʷ޽ʱŻߵнʱ commit Ѱʷ滻գ
+        if (!pool_reliable_ || !data_writer_) {
+            // Ϊдûȷϣ޷ж; buffer Ѳٱм
+            Logger::getInstance().error(
+                "[DDSManager_ZeroCopyBytes] 㿽غľ (" + std::to_string(buffer_pool_.slots()) +
+                " )BEST_EFFORT д޷ȷ; buffer ͷţseq=" + std::to_string(sequence) +
+                "Ϊдн history / resource_limits m_zeroCopyPoolSize 󵽲Сڱַ"
+            );
+            return false;
+        }
+        // ɿдˣȫȷϺмд buffer
+        DDS::Duration_t timeout = { 10, 0 };
+        const DDS::ReturnCode_t ret = data_writer_->wait_for_acknowledgments(timeout);
+        ++pool_ack_waits_;
+        if (ret != DDS::RETCODE_OK) {
+            ++pool_ack_failures_;
+            Logger::getInstance().error(
+                "[DDSManager_ZeroCopyBytes] غľȴȷʧ (ret=" + std::to_string(ret) +
+                "); buffer գseq=" + std::to_string(sequence)
+            );
+            return false;
+        }
+        buffer_pool_.recycleAll();
+        index = buffer_pool_.acquire();
+        if (index < 0) {
+            return false;
+        }
+    }
+
+    const size_t header_size = sizeof(PacketHeader);
+    size_t length = std::max(static_cast<size_t>(std::max(dataSize, 0)), header_size);
+    if (length > buffer_pool_.userCapacity()) {
+        buffer_pool_.release(index);
+        return false;
+    }
+
+    char* base = buffer_pool_.buffer(static_cast<size_t>(index));
+    sample.totalLength = static_cast<DDS_ULong>(buffer_pool_.userCapacity() + DEFAULT_HEADER_RESERVE);
+    sample.reservedLength = DEFAULT_HEADER_RESERVE;
+    sample.value = base;
+    sample.userBuffer = base + DEFAULT_HEADER_RESERVE;
+    sample.userLength = static_cast<DDS_ULong>(length);
+
+    PacketHeader* hdr = reinterpret_cast<PacketHeader*>(sample.userBuffer);
+    hdr->sequence = sequence;
+    hdr->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+    hdr->packet_type = 0;
+
+    pending_index_ = index;
+    return true;
+}
+
+void DDSManager_ZeroCopyBytes::commitPooledSample(bool written) {
+    if (pending_index_ < 0) return;
+    if (written) {
+        buffer_pool_.markInFlight(pending_index_);
+        // ;дʷȣϵѱ滻ȷƳм buffer
+        while (writer_depth_ > 0 && buffer_pool_.inFlightCount() > static_cast<size_t>(writer_depth_)) {
+            buffer_pool_.recycleOldest();
+            ++pool_history_recycles_;
+        }
+    }
+    else {
+        buffer_pool_.release(pending_index_);
+    }
+    pending_index_ = -1;
+}
+
+void DDSManager_ZeroCopyBytes::cleanupBufferPool() {
+    if (buffer_pool_.empty()) return;
+
+    Logger::getInstance().logAndPrint(
+        "[DDSManager_ZeroCopyBytes] 㿽ͳ: ȡ=" + std::to_string(buffer_pool_.acquireCount()) +
+        ", ľ=" + std::to_string(buffer_pool_.exhaustedCount()) +
+        ", ʷ滻=" + std::to_string(pool_history_recycles_) +
+        ", ȴȷ=" + std::to_string(pool_ack_waits_) +
+        ", ȷʧ=" + std::to_string(pool_ack_failures_)
+    );
+
+    buffer_pool_.destroy();
+    pending_index_ = -1;
+    writer_depth_ = 0;
+    pool_history_recycles_ = 0;
+    pool_ack_waits_ = 0;
+    pool_ack_failures_ = 0;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "DomainParticipant.h"
 #include "DomainParticipantFactory.h"
 #include "ZRBuiltinTypes.h"  
+#include "ZeroCopyBufferPool.h"
 
 using OnDataReceivedCallback_ZC = std::function<void(const DDS_ZeroCopyBytes&, const DDS::SampleInfo&)>;
 using OnEndOfRoundCallback = std::function<void()>;
@@ -31,6 +32,10 @@ public:
 
     bool ensureBufferSize(size_t user_data_size);
 
+    // ping-pong ʱӲԣͶд topic topic_echoն˷֮ initialize ǰã
+    void setEchoMode(bool enable) { echo_mode_ = enable; }
+    bool isEchoMode() const { return echo_mode_; }
+
     // ṩʵʽӿ
     DDS::DomainParticipant* get_participant() const { return participant_; }
     DDS::DataWriter* get_data_writer() const { return data_writer_; }
@@ -42,6 +47,22 @@ public:
     bool prepareZeroCopyData(DDS_ZeroCopyBytes& sample, int dataSize, uint32_t sequence);
     bool prepareEndZeroCopyData(DDS_ZeroCopyBytes& sample);
 
+    //  buffer ͳأslots ͬ m_zeroCopyPoolSize< 0 д history / resource_limits 㣩
+    // дʷнʱٷ  + 1 
+    bool prepareBufferPool(int slots, size_t user_data_size);
+    // ӳȡ buffer  sampleдʷнʱزľʷ޽ʱغľ
+    // ɿд˵ȴȷٻգȷϳʱΪд˷ false÷Ӧֹ
+    bool acquirePooledSample(DDS_ZeroCopyBytes& sample, int dataSize, uint32_t sequence);
+    // write غãдɹ buffer ;Удʷȵ buffer 漴գ
+    // ʧֱܵӹ黹
+    void commitPooledSample(bool written);
+    // wait_for_acknowledgments  RETCODE_OK ֮ãȫ; buffer
+    size_t recycleBufferPool() { return buffer_pool_.recycleAll(); }
+    // ͷųڴ棺ȷδʱҪãshutdown ɾʵ֮ͷ
+    void cleanupBufferPool();
+    bool hasBufferPool() const { return !buffer_pool_.empty(); }
+    const ZeroCopyBufferPool& bufferPool() const { return buffer_pool_; }
+
 private:
     std::string xml_qos_file_path_;
 
@@ -60,10 +81,23 @@ private:
     size_t max_possible_size_; // ݰСԤ
     char* global_buffer_;      // ԤȷĴڴ
 
+    // ͻ
+    static constexpr int DEFAULT_POOL_SLOTS = 32;
+    static constexpr int MAX_POOL_SLOTS = 1024;
+    static constexpr size_t MAX_POOL_BYTES = 256u * 1024u * 1024u;
+    ZeroCopyBufferPool buffer_pool_;
+    int pending_index_ = -1;        //  acquire δ commit ±
+    bool pool_reliable_ = false;    // дǷ RELIABLEغľʱĻշʽ
+    int writer_depth_ = 0;          // дʷõ0 ʾ޽
+    uint64_t pool_history_recycles_ = 0;
+    uint64_t pool_ack_waits_ = 0;
+    uint64_t pool_ack_failures_ = 0;
+
     // DDS ʵ
     DDS::DomainParticipantFactory* factory_ = nullptr;
     DDS::DomainParticipant* participant_ = nullptr;
     DDS::Topic* topic_ = nullptr;
+    DDS::Topic* echo_topic_ = nullptr;
     DDS::DataWriter* data_writer_ = nullptr;
     DDS::DataReader* data_reader_ = nullptr;
 
@@ -71,4 +105,5 @@ private:
     MyDataReaderListener* listener_ = nullptr;
 
     bool is_initialized_ = false;
+    bool echo_mode_ = false;
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+﻿// ZeroCopyBufferPool.cpp
+#include "ZeroCopyBufferPool.h"
+#include "GloMemPool.h"
+
+ZeroCopyBufferPool::~ZeroCopyBufferPool() {
+    destroy();
+}
+
+bool ZeroCopyBufferPool::create(int slots, size_t reserve, size_t user_size) {
+    destroy();
+    if (slots <= 0) {
+        return false;
+    }
+
+    reserve_ = reserve;
+    user_size_ = user_size;
+    buffer_bytes_ = (reserve + user_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    const size_t count = static_cast<size_t>(slots);
+    raw_.reserve(count);
+    buffers_.reserve(count);
+    free_list_.reserve(count);
+    in_flight_.assign(count, -1);
+
+    for (size_t i = 0; i < count; ++i) {
+        // 多分配 ALIGNMENT - 1 字节用于手动对齐
+        char* raw = static_cast<char*>(GloMemPool::allocate(buffer_bytes_ + ALIGNMENT - 1, __FILE__, __LINE__));
+        if (!raw) {
+            destroy();
+            return false;
+        }
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+        char* aligned = raw + ((ALIGNMENT - (addr & (ALIGNMENT - 1))) & (ALIGNMENT - 1));
+        raw_.push_back(raw);
+        buffers_.push_back(aligned);
+    }
+
+    // 倒序压栈，使 acquire 先拿到下标 0
+    for (size_t i = count; i > 0; --i) {
+        free_list_.push_back(static_cast<int>(i - 1));
+    }
+    return true;
+}
+
+void ZeroCopyBufferPool::destroy() {
+    for (char* raw : raw_) {
+        GloMemPool::deallocate(raw);
+    }
+    raw_.clear();
+    buffers_.clear();
+    free_list_.clear();
+    in_flight_.clear();
+    in_flight_head_ = 0;
+    in_flight_count_ = 0;
+    reserve_ = 0;
+    user_size_ = 0;
+    buffer_bytes_ = 0;
+    acquires_ = 0;
+    exhausted_ = 0;
+}
+
+int ZeroCopyBufferPool::acquire() {
+    if (free_list_.empty()) {
+        ++exhausted_;
+        return -1;
+    }
+    const int index = free_list_.back();
+    free_list_.pop_back();
+    ++acquires_;
+    return index;
+}
+
+void ZeroCopyBufferPool::markInFlight(int index) {
+    if (index < 0 || in_flight_count_ >= in_flight_.size()) {
+        return;
+    }
+    const size_t tail = (in_flight_head_ + in_flight_count_) % in_flight_.size();
+    in_flight_[tail] = index;
+    ++in_flight_count_;
+}
+
+void ZeroCopyBufferPool::release(int index) {
+    if (index >= 0 && free_list_.size() < buffers_.size()) {
+        free_list_.push_back(index);
+    }
+}
+
+bool ZeroCopyBufferPool::recycleOldest() {
+    if (in_flight_count_ == 0) {
+        return false;
+    }
+    free_list_.push_back(in_flight_[in_flight_head_]);
+    in_flight_head_ = (in_flight_head_ + 1) % in_flight_.size();
+    --in_flight_count_;
+    return true;
+}
+
+size_t ZeroCopyBufferPool::recycleAll() {
+    const size_t n = in_flight_count_;
+    while (recycleOldest()) {
+    }
+    return n;
+}
@@ -0,0 +1,65 @@
+﻿// ZeroCopyBufferPool.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 零拷贝发送缓冲池：固定数量、按缓存行对齐的 buffer（头部预留 + 最大用户数据），
+// 空闲链表 + 在途 FIFO。write 之后 buffer 进入在途队列，
+// 只有被写端历史替换（在途数超过历史深度时的最老者）或确认（wait_for_acknowledgments 返回 OK）后
+// 才回到空闲链表，避免覆盖仍被中间件引用的数据。
+class ZeroCopyBufferPool {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    ZeroCopyBufferPool() = default;
+    ~ZeroCopyBufferPool();
+
+    ZeroCopyBufferPool(const ZeroCopyBufferPool&) = delete;
+    ZeroCopyBufferPool& operator=(const ZeroCopyBufferPool&) = delete;
+
+    // 分配 slots 个 buffer，每个 reserve + user_size 字节（向上对齐到 ALIGNMENT）
+    bool create(int slots, size_t reserve, size_t user_size);
+    void destroy();
+
+    bool empty() const { return buffers_.empty(); }
+    size_t slots() const { return buffers_.size(); }
+    size_t bufferBytes() const { return buffer_bytes_; }
+    size_t reserve() const { return reserve_; }
+    size_t userCapacity() const { return user_size_; }
+    size_t freeCount() const { return free_list_.size(); }
+    size_t inFlightCount() const { return in_flight_count_; }
+
+    char* buffer(size_t index) const { return buffers_[index]; }
+
+    // 取一个空闲 buffer，返回下标；无空闲时返回 -1
+    int acquire();
+    // 已 write 的 buffer 进入在途队列（按写出顺序）
+    void markInFlight(int index);
+    // 未写出的 buffer 直接归还
+    void release(int index);
+
+    // 回收最老的在途 buffer（仅在确认其已被释放时调用），返回是否成功
+    bool recycleOldest();
+    // 写端确认全部样本后：回收所有在途 buffer，返回回收数量
+    size_t recycleAll();
+
+    // 统计
+    uint64_t acquireCount() const { return acquires_; }
+    uint64_t exhaustedCount() const { return exhausted_; }
+
+private:
+    std::vector<char*> raw_;       // GloMemPool 返回的原始指针（释放用）
+    std::vector<char*> buffers_;   // 对齐后的 buffer 起始地址
+    std::vector<int> free_list_;   // 空闲下标栈（容量预留为 slots，运行期不分配）
+    std::vector<int> in_flight_;   // 在途下标环形队列
+    size_t in_flight_head_ = 0;
+    size_t in_flight_count_ = 0;
+
+    size_t reserve_ = 0;
+    size_t user_size_ = 0;
+    size_t buffer_bytes_ = 0;
+
+    uint64_t acquires_ = 0;
+    uint64_t exhausted_ = 0;
+};
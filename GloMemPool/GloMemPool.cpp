@@ -1,10 +1,218 @@
 ﻿#include "GloMemPool.h"
 
+#include <cstring>
+#include <thread>
+
 ZRMemPool* GloMemPool::s_pool = nullptr;
-GloMemPool::Stats GloMemPool::s_stats;
+GloMemPool::ThreadCounters GloMemPool::s_counters[GloMemPool::MAX_COUNTER_SLOTS];
+std::atomic<int> GloMemPool::s_counter_high{ 0 };
+std::atomic<size_t> GloMemPool::s_peak_usage{ 0 };
+std::atomic<int64_t> GloMemPool::s_usage_bytes{ 0 };
+GloMemPool::SlabClass GloMemPool::s_classes[GloMemPool::SLAB_CLASS_COUNT];
+std::atomic<size_t> GloMemPool::s_direct_allocs{ 0 };
+#ifdef GLOMEMPOOL_DISABLE_SLAB
+std::atomic<bool> GloMemPool::s_slab_enabled{ false };
+#else
+std::atomic<bool> GloMemPool::s_slab_enabled{ true };
+#endif
+#ifdef GLOMEMPOOL_DISABLE_MAGAZINE
+std::atomic<bool> GloMemPool::s_magazine_enabled{ false };
+#else
+std::atomic<bool> GloMemPool::s_magazine_enabled{ true };
+#endif
+std::mutex GloMemPool::s_cache_registry_mutex;
+GloMemPool::ThreadCache* GloMemPool::s_cache_head = nullptr;
 
 #ifdef _MEMORY_USE_TRACK_
-std::unordered_map<void*, size_t> GloMemPool::s_alloc_map;
+GloMemPool::TrackShard GloMemPool::s_track[GloMemPool::TRACK_SHARDS];
+#endif
+
+namespace {
+    // 线程退出时归还计数槽；t_counters_released 为平凡类型，析构顺序之后仍可安全读取
+    thread_local bool t_counters_released = false;
+    // 线程本地 magazine 已析构（线程退出阶段），此后的分配/释放直接走 slab
+    thread_local bool t_cache_released = false;
+    // 快路径用的平凡 TLS 指针，避免每次访问带析构函数的 thread_local 时的初始化检查
+    thread_local void* t_counters = nullptr;
+    thread_local void* t_cache = nullptr;
+#ifdef _MEMORY_USE_TRACK_
+    // 跟踪表自身的 unordered_map 节点分配（全局 new/delete 重载时）不再递归跟踪
+    thread_local bool t_in_track = false;
+#endif
+}
+
+GloMemPool::ThreadCounters& GloMemPool::localCounters(bool& shared) {
+    struct SlotGuard {
+        ThreadCounters* slot = nullptr;
+        ~SlotGuard() {
+            if (slot) {
+                // 未并入的净分配字节随线程退出一并并入，槽位复用时从 0 开始
+                const int64_t pending = slot->pending_bytes.exchange(0, std::memory_order_relaxed);
+                if (pending != 0) {
+                    s_usage_bytes.fetch_add(pending, std::memory_order_relaxed);
+                }
+                slot->in_use.store(false, std::memory_order_release);
+            }
+            t_counters = nullptr;
+            t_counters_released = true;
+        }
+    };
+    if (t_counters) {
+        shared = false;
+        return *static_cast<ThreadCounters*>(t_counters);
+    }
+
+    ThreadCounters& overflow = s_counters[MAX_COUNTER_SLOTS - 1];
+    if (t_counters_released) {
+        shared = true;
+        return overflow;
+    }
+
+    for (int i = 0; i < MAX_COUNTER_SLOTS - 1; ++i) {
+        bool expected = false;
+        if (s_counters[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            int high = s_counter_high.load(std::memory_order_relaxed);
+            while (high < i + 1 && !s_counter_high.compare_exchange_weak(high, i + 1, std::memory_order_relaxed)) {
+            }
+            thread_local SlotGuard guard;
+            guard.slot = &s_counters[i];
+            t_counters = guard.slot;
+            shared = false;
+            return *guard.slot;
+        }
+    }
+    shared = true;
+    return overflow;
+}
+
+void GloMemPool::countAlloc(size_t size) {
+    bool shared = false;
+    ThreadCounters& c = localCounters(shared);
+    if (shared) {
+        c.alloc_count.fetch_add(1, std::memory_order_relaxed);
+        c.bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+    }
+    else {
+        // 单写者：load + store 即可，避免 lock 前缀指令
+        c.alloc_count.store(c.alloc_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        c.bytes_allocated.store(c.bytes_allocated.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+    addUsage(c, shared, static_cast<int64_t>(size));
+}
+
+void GloMemPool::countFree(size_t size) {
+    bool shared = false;
+    ThreadCounters& c = localCounters(shared);
+    if (shared) {
+        c.dealloc_count.fetch_add(1, std::memory_order_relaxed);
+        c.bytes_freed.fetch_add(size, std::memory_order_relaxed);
+    }
+    else {
+        c.dealloc_count.store(c.dealloc_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        c.bytes_freed.store(c.bytes_freed.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+    addUsage(c, shared, -static_cast<int64_t>(size));
+}
+
+void GloMemPool::addUsage(ThreadCounters& c, bool shared, int64_t delta) {
+    if (!shared) {
+        // 单写者：本线程内累积，批量并入全局用量
+        const int64_t pending = c.pending_bytes.load(std::memory_order_relaxed) + delta;
+        if (pending < PEAK_BATCH_BYTES && pending > -PEAK_BATCH_BYTES) {
+            c.pending_bytes.store(pending, std::memory_order_relaxed);
+            return;
+        }
+        c.pending_bytes.store(0, std::memory_order_relaxed);
+        delta = pending;
+    }
+    const int64_t usage = s_usage_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (usage > 0) {
+        raisePeak(static_cast<size_t>(usage));
+    }
+}
+
+void GloMemPool::raisePeak(size_t usage) {
+    size_t peak = s_peak_usage.load(std::memory_order_relaxed);
+    while (usage > peak && !s_peak_usage.compare_exchange_weak(peak, usage, std::memory_order_relaxed)) {
+    }
+}
+
+void GloMemPool::countCache(std::atomic<uint64_t> ThreadCounters::* field) {
+    bool shared = false;
+    std::atomic<uint64_t>& v = localCounters(shared).*field;
+    if (shared) {
+        v.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+        v.store(v.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+GloMemPool::Stats GloMemPool::aggregate() {
+    uint64_t allocs = 0, deallocs = 0, bytes_in = 0, bytes_out = 0;
+    uint64_t hits = 0, misses = 0, flushes = 0;
+    const int high = s_counter_high.load(std::memory_order_acquire);
+    auto add = [&](const ThreadCounters& c) {
+        allocs += c.alloc_count.load(std::memory_order_relaxed);
+        deallocs += c.dealloc_count.load(std::memory_order_relaxed);
+        bytes_in += c.bytes_allocated.load(std::memory_order_relaxed);
+        bytes_out += c.bytes_freed.load(std::memory_order_relaxed);
+        hits += c.cache_hits.load(std::memory_order_relaxed);
+        misses += c.cache_misses.load(std::memory_order_relaxed);
+        flushes += c.cache_flushes.load(std::memory_order_relaxed);
+    };
+    for (int i = 0; i < high; ++i) {
+        add(s_counters[i]);
+    }
+    add(s_counters[MAX_COUNTER_SLOTS - 1]);
+
+    // 各线程计数读取时刻不同，释放可能先于对应分配被看到，差值按 0 截断
+    Stats st;
+    st.alloc_count = static_cast<size_t>(allocs);
+    st.dealloc_count = static_cast<size_t>(deallocs);
+    st.total_allocated = bytes_in > bytes_out ? static_cast<size_t>(bytes_in - bytes_out) : 0;
+    st.current_blocks = allocs > deallocs ? static_cast<size_t>(allocs - deallocs) : 0;
+    st.peak_usage = s_peak_usage.load(std::memory_order_relaxed);
+    st.cache_hits = static_cast<size_t>(hits);
+    st.cache_misses = static_cast<size_t>(misses);
+    st.cache_flushes = static_cast<size_t>(flushes);
+    st.cache_hit_rate = (hits + misses) > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+    return st;
+}
+
+// 读取统计时用精确汇总值补一次峰值（批量并入之间的增长）
+void GloMemPool::refreshPeak() {
+    raisePeak(aggregate().total_allocated);
+}
+
+#ifdef _MEMORY_USE_TRACK_
+GloMemPool::TrackShard& GloMemPool::trackShard(void* ptr) {
+    // 块至少 16 字节对齐，低 4 位无信息；乘法哈希取高位
+    const uint64_t h = (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) >> 4) * 0x9E3779B97F4A7C15ull;
+    return s_track[h >> 58];
+}
+
+void GloMemPool::trackInsert(void* ptr, size_t size, const char* file, int line) {
+    if (t_in_track) return;
+    t_in_track = true;
+    TrackShard& shard = trackShard(ptr);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map[ptr] = TrackInfo{ size, file, line };
+    }
+    t_in_track = false;
+}
+
+void GloMemPool::trackErase(void* ptr) {
+    if (t_in_track) return;
+    t_in_track = true;
+    TrackShard& shard = trackShard(ptr);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.erase(ptr);
+    }
+    t_in_track = false;
+}
 #endif
 
 bool GloMemPool::initialize() {
@@ -14,29 +222,46 @@ bool GloMemPool::initialize() {
 }
 
 void GloMemPool::finalize() {
+    flushAllThreadCaches();
+    releaseSlabs();
     ZRFinalizeGlobalMemPool();
     s_pool = nullptr;// 清空内存
 }
 
 void* GloMemPool::allocate(size_t size, const char* file, int line) {
     void* ptr = nullptr;
+    const int size_class = s_slab_enabled.load(std::memory_order_relaxed) ? sizeClassOf(size) : -1;
 
+    BlockHeader* header = nullptr;
+    if (size_class >= 0) {
+        header = static_cast<BlockHeader*>(magazinePop(size_class));
+        if (!header) {
+            header = static_cast<BlockHeader*>(slabAllocate(size_class));
+        }
+    }
+    else {
+        const DDS_ULong total = static_cast<DDS_ULong>(size + sizeof(BlockHeader));
 #ifdef _MEMORY_USE_TRACK_
-    ptr = ZRMallocWCallInfo(s_pool, static_cast<DDS_ULong>(size), file, __FUNCTION__, line);
+        header = static_cast<BlockHeader*>(ZRMallocWCallInfo(s_pool, total, file, __FUNCTION__, line));
 #else
-    ptr = ZRMalloc(s_pool, static_cast<DDS_ULong>(size));
+        header = static_cast<BlockHeader*>(ZRMalloc(s_pool, total));
 #endif
-
-    if (ptr) {
-        s_stats.total_allocated += size;
-        s_stats.alloc_count++;
-        s_stats.current_blocks++;
-        if (s_stats.total_allocated > s_stats.peak_usage) {
-            s_stats.peak_usage = s_stats.total_allocated;
+        if (header) {
+            s_direct_allocs.fetch_add(1, std::memory_order_relaxed);
         }
+    }
+
+    if (header) {
+        header->magic = BLOCK_MAGIC;
+        header->size_class = size_class;
+        header->size = size;
+        ptr = header + 1;
+
+        // 峰值随计数批量更新（见 PEAK_BATCH_BYTES），magazine / 已有大块上的分配同样计入
+        countAlloc(size);
 
 #ifdef _MEMORY_USE_TRACK_
-        s_alloc_map[ptr] = size;
+        trackInsert(ptr, size, file, line);
 #endif
     }
 
@@ -46,45 +271,338 @@ void* GloMemPool::allocate(size_t size, const char* file, int line) {
 void GloMemPool::deallocate(void* ptr) {
     if (!ptr) return;
 
-    ZRDealloc(s_pool, ptr);
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (header->magic != BLOCK_MAGIC) {
+        // 重复释放或非本池分配的指针，不做处理
+        return;
+    }
+    header->magic = 0;
+    const int size_class = header->size_class;
+    const size_t size = static_cast<size_t>(header->size);
 
-#ifdef _MEMORY_USE_TRACK_
-    auto it = s_alloc_map.find(ptr);
-    if (it != s_alloc_map.end()) {
-        size_t size = it->second;
-        s_stats.total_allocated -= size;
-        s_stats.current_blocks--;
-        s_stats.dealloc_count++;
-        s_alloc_map.erase(it);
+    if (size_class >= 0) {
+        if (!magazinePush(size_class, header)) {
+            slabFree(size_class, header);
+        }
     }
     else {
-        s_stats.dealloc_count++;
+        ZRDealloc(s_pool, header);
     }
-#else
-    s_stats.dealloc_count++;
-    s_stats.current_blocks--;
+
+    countFree(size);
+
+#ifdef _MEMORY_USE_TRACK_
+    trackErase(ptr);
 #endif
 }
 
+int GloMemPool::sizeClassOf(size_t size) {
+    if (size > (static_cast<size_t>(1) << SLAB_MAX_SHIFT)) {
+        return -1;
+    }
+    int shift = SLAB_MIN_SHIFT;
+    while ((static_cast<size_t>(1) << shift) < size) {
+        ++shift;
+    }
+    return shift - SLAB_MIN_SHIFT;
+}
+
+// 调用方须持有 s_classes[size_class].mutex
+void* GloMemPool::slabTakeLocked(int size_class) {
+    SlabClass& cls = s_classes[size_class];
+    const size_t stride = sizeof(BlockHeader) + (static_cast<size_t>(1) << (size_class + SLAB_MIN_SHIFT));
+
+    void* block = nullptr;
+    if (cls.free_list) {
+        block = cls.free_list;
+        cls.free_list = cls.free_list->next;
+    }
+    else {
+        if (!cls.bump || static_cast<size_t>(cls.bump_end - cls.bump) < stride) {
+            // 当前大块用尽，向 ZRMalloc 申请新大块（大块按 stride 整除，不留碎片）
+            size_t blocks = SLAB_CHUNK_BYTES / stride;
+            if (blocks < SLAB_MIN_BLOCKS_PER_CHUNK) {
+                blocks = SLAB_MIN_BLOCKS_PER_CHUNK;
+            }
+            const size_t chunk_bytes = sizeof(ChunkHeader) + blocks * stride;
+            ChunkHeader* chunk = static_cast<ChunkHeader*>(ZRMalloc(s_pool, static_cast<DDS_ULong>(chunk_bytes)));
+            if (!chunk) {
+                return nullptr;
+            }
+            chunk->next = cls.chunks;
+            cls.chunks = chunk;
+            cls.bump = reinterpret_cast<char*>(chunk + 1);
+            cls.bump_end = reinterpret_cast<char*>(chunk) + chunk_bytes;
+            cls.stats.chunks++;
+        }
+        block = cls.bump;
+        cls.bump += stride;
+        cls.stats.blocks_carved++;
+    }
+
+    cls.stats.alloc_count++;
+    cls.stats.blocks_in_use++;
+    if (cls.stats.blocks_in_use > cls.stats.peak_in_use) {
+        cls.stats.peak_in_use = cls.stats.blocks_in_use;
+    }
+    return block;
+}
+
+// 调用方须持有 s_classes[size_class].mutex
+void GloMemPool::slabPutLocked(int size_class, void* block) {
+    SlabClass& cls = s_classes[size_class];
+    FreeNode* node = static_cast<FreeNode*>(block);
+    node->next = cls.free_list;
+    cls.free_list = node;
+    cls.stats.free_count++;
+    cls.stats.blocks_in_use--;
+}
+
+void* GloMemPool::slabAllocate(int size_class) {
+    std::lock_guard<std::mutex> lock(s_classes[size_class].mutex);
+    return slabTakeLocked(size_class);
+}
+
+int GloMemPool::slabAllocateBatch(int size_class, void** out, int count) {
+    std::lock_guard<std::mutex> lock(s_classes[size_class].mutex);
+    int n = 0;
+    while (n < count) {
+        void* block = slabTakeLocked(size_class);
+        if (!block) break;
+        out[n++] = block;
+    }
+    return n;
+}
+
+void GloMemPool::slabFree(int size_class, BlockHeader* header) {
+    std::lock_guard<std::mutex> lock(s_classes[size_class].mutex);
+    slabPutLocked(size_class, header);
+}
+
+void GloMemPool::slabFreeBatch(int size_class, void* const* blocks, int count) {
+    if (count <= 0) return;
+    std::lock_guard<std::mutex> lock(s_classes[size_class].mutex);
+    for (int i = 0; i < count; ++i) {
+        slabPutLocked(size_class, blocks[i]);
+    }
+}
+
+// -------------------------------
+// 线程本地 magazine
+// -------------------------------
+
+GloMemPool::ThreadCache::ThreadCache() {
+    std::lock_guard<std::mutex> lock(s_cache_registry_mutex);
+    next = s_cache_head;
+    if (next) {
+        next->prev = this;
+    }
+    s_cache_head = this;
+}
+
+GloMemPool::ThreadCache::~ThreadCache() {
+    {
+        std::lock_guard<std::mutex> lock(s_cache_registry_mutex);
+        if (prev) {
+            prev->next = next;
+        }
+        else {
+            s_cache_head = next;
+        }
+        if (next) {
+            next->prev = prev;
+        }
+    }
+    // 已移出登记表，其他线程不会再访问，无需持有 busy
+    drainCache(this);
+    t_cache = nullptr;
+    t_cache_released = true;
+}
+
+GloMemPool::ThreadCache* GloMemPool::threadCache() {
+    if (t_cache) {
+        return static_cast<ThreadCache*>(t_cache);
+    }
+    if (t_cache_released) {
+        return nullptr;
+    }
+    thread_local ThreadCache cache;
+    t_cache = &cache;
+    return &cache;
+}
+
+int GloMemPool::magazineCapacity(int size_class) {
+    return (size_class + SLAB_MIN_SHIFT) <= 12 ? MAGAZINE_CAPACITY : MAGAZINE_LARGE_CAPACITY;
+}
+
+void* GloMemPool::magazinePop(int size_class) {
+    if (!s_magazine_enabled.load(std::memory_order_relaxed) || size_class >= MAGAZINE_CLASS_COUNT) {
+        return nullptr;
+    }
+    ThreadCache* cache = threadCache();
+    if (!cache || cache->busy.exchange(true, std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // 取得 busy 后复核开关：关闭并排空之后不再往 magazine 里取/放
+    void* block = nullptr;
+    if (s_magazine_enabled.load(std::memory_order_relaxed)) {
+        Magazine& mag = cache->magazines[size_class];
+        if (mag.count > 0) {
+            countCache(&ThreadCounters::cache_hits);
+            block = mag.blocks[--mag.count];
+        }
+        else {
+            // 空：一次加锁补充半个 magazine
+            countCache(&ThreadCounters::cache_misses);
+            mag.count = slabAllocateBatch(size_class, mag.blocks, magazineCapacity(size_class) / 2);
+            block = mag.count > 0 ? mag.blocks[--mag.count] : nullptr;
+        }
+    }
+    cache->busy.store(false, std::memory_order_release);
+    return block;
+}
+
+bool GloMemPool::magazinePush(int size_class, void* block) {
+    if (!s_magazine_enabled.load(std::memory_order_relaxed) || size_class >= MAGAZINE_CLASS_COUNT) {
+        return false;
+    }
+    ThreadCache* cache = threadCache();
+    if (!cache || cache->busy.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+
+    bool pushed = false;
+    if (s_magazine_enabled.load(std::memory_order_relaxed)) {
+        Magazine& mag = cache->magazines[size_class];
+        const int capacity = magazineCapacity(size_class);
+        if (mag.count >= capacity) {
+            // 满：把栈底较冷的一半批量归还 slab，栈顶较热的块留在本线程
+            const int batch = capacity / 2;
+            slabFreeBatch(size_class, mag.blocks, batch);
+            std::memmove(mag.blocks, mag.blocks + batch, static_cast<size_t>(mag.count - batch) * sizeof(void*));
+            mag.count -= batch;
+            countCache(&ThreadCounters::cache_flushes);
+        }
+        mag.blocks[mag.count++] = block;
+        pushed = true;
+    }
+    cache->busy.store(false, std::memory_order_release);
+    return pushed;
+}
+
+void GloMemPool::lockCache(ThreadCache* cache) {
+    while (cache->busy.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void GloMemPool::drainCache(ThreadCache* cache) {
+    for (int c = 0; c < MAGAZINE_CLASS_COUNT; ++c) {
+        slabFreeBatch(c, cache->magazines[c].blocks, cache->magazines[c].count);
+        cache->magazines[c].count = 0;
+    }
+}
+
+void GloMemPool::flushThreadCache() {
+    ThreadCache* cache = threadCache();
+    if (!cache) return;
+    lockCache(cache);
+    drainCache(cache);
+    cache->busy.store(false, std::memory_order_release);
+}
+
+void GloMemPool::flushAllThreadCaches() {
+    std::lock_guard<std::mutex> lock(s_cache_registry_mutex);
+    for (ThreadCache* cache = s_cache_head; cache; cache = cache->next) {
+        lockCache(cache);
+        drainCache(cache);
+        cache->busy.store(false, std::memory_order_release);
+    }
+}
+
+void GloMemPool::releaseSlabs() {
+    for (int c = 0; c < SLAB_CLASS_COUNT; ++c) {
+        SlabClass& cls = s_classes[c];
+        std::lock_guard<std::mutex> lock(cls.mutex);
+        if (cls.stats.blocks_in_use != 0) {
+            // 仍有块未归还，保留大块以免悬空指针被访问（泄漏由 hasPotentialLeak 报告）
+            continue;
+        }
+        while (cls.chunks) {
+            ChunkHeader* next = cls.chunks->next;
+            ZRDealloc(s_pool, cls.chunks);
+            cls.chunks = next;
+        }
+        cls.free_list = nullptr;
+        cls.bump = nullptr;
+        cls.bump_end = nullptr;
+        cls.stats.chunks = 0;
+        cls.stats.blocks_carved = 0;
+    }
+}
+
+std::array<GloMemPool::SlabClassStats, GloMemPool::SLAB_CLASS_COUNT> GloMemPool::getSlabStats() {
+    std::array<SlabClassStats, SLAB_CLASS_COUNT> result;
+    for (int c = 0; c < SLAB_CLASS_COUNT; ++c) {
+        std::lock_guard<std::mutex> lock(s_classes[c].mutex);
+        result[c] = s_classes[c].stats;
+        result[c].block_size = static_cast<size_t>(1) << (c + SLAB_MIN_SHIFT);
+    }
+    return result;
+}
+
+size_t GloMemPool::getDirectAllocCount() {
+    return s_direct_allocs.load(std::memory_order_relaxed);
+}
+
+void GloMemPool::setMagazineEnabled(bool enable) {
+    s_magazine_enabled.store(enable, std::memory_order_relaxed);
+    if (!enable) {
+        // 先关开关再排空：排空后取得 busy 的线程都会看到已关闭，不会再放回块
+        flushAllThreadCaches();
+    }
+}
+
+bool GloMemPool::isMagazineEnabled() {
+    return s_magazine_enabled.load(std::memory_order_relaxed);
+}
+
+void GloMemPool::setSlabEnabled(bool enable) {
+    s_slab_enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool GloMemPool::isSlabEnabled() {
+    return s_slab_enabled.load(std::memory_order_relaxed);
+}
+
 GloMemPool::Stats GloMemPool::getStats() {
-    return s_stats;
+    refreshPeak();
+    return aggregate();
 }
 
 bool GloMemPool::hasPotentialLeak() {
-    return s_stats.alloc_count > s_stats.dealloc_count;
+    const Stats st = aggregate();
+    return st.alloc_count > st.dealloc_count;
 }
 
 size_t GloMemPool::getOutstandingAllocations() {
-    return s_stats.alloc_count - s_stats.dealloc_count;
+    const Stats st = aggregate();
+    return st.alloc_count > st.dealloc_count ? st.alloc_count - st.dealloc_count : 0;
 }
 
 size_t GloMemPool::getCurrentBlocks() {
-    return s_stats.current_blocks;
+    return aggregate().current_blocks;
 }
 
 #ifdef _MEMORY_USE_TRACK_
 size_t GloMemPool::getTrackedCount() {
-    return s_alloc_map.size();
+    size_t total = 0;
+    for (auto& shard : s_track) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.map.size();
+    }
+    return total;
 }
 #endif
 
@@ -114,4 +632,13 @@ void operator delete[](void* ptr) noexcept {
     GloMemPool::deallocate(ptr);
 }
 
+// 编译器可能直接调用带大小的版本（C++14），须一并重载，否则会绕过本池释放
+void operator delete(void* ptr, size_t) noexcept {
+    GloMemPool::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    GloMemPool::deallocate(ptr);
+}
+
 #endif
\ No newline at end of file
@@ -1,6 +1,10 @@
 ﻿// GloMemPool.h
 #pragma once
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <string>
 
 #include "ZRMemPool.h"
@@ -17,6 +21,36 @@ public:
         size_t alloc_count = 0;
         size_t dealloc_count = 0;
         size_t current_blocks = 0;
+
+        // 线程本地 magazine 缓存
+        size_t cache_hits = 0;      // 直接从本线程 magazine 取到块
+        size_t cache_misses = 0;    // magazine 为空，批量向 slab 补充
+        size_t cache_flushes = 0;   // magazine 满，批量归还 slab
+        double cache_hit_rate = 0.0;
+    };
+
+    // 2 的幂尺寸类：64 B ~ 1 MB，超出范围的请求直接走 ZRMalloc
+    static constexpr int SLAB_MIN_SHIFT = 6;
+    static constexpr int SLAB_MAX_SHIFT = 20;
+    static constexpr int SLAB_CLASS_COUNT = SLAB_MAX_SHIFT - SLAB_MIN_SHIFT + 1;
+    static constexpr size_t SLAB_CHUNK_BYTES = 1u << 20;   // 每次向 ZRMalloc 申请的大块
+    static constexpr size_t SLAB_MIN_BLOCKS_PER_CHUNK = 4;  // 大尺寸类每块至少切出的块数
+
+    // 线程本地 magazine：64 B ~ 64 KB 的尺寸类在每个线程各有一个小栈，
+    // 取/还优先走本线程栈，空时批量补充、满时批量归还 slab，只在批量操作时加锁
+    static constexpr int MAGAZINE_MAX_SHIFT = 16;
+    static constexpr int MAGAZINE_CLASS_COUNT = MAGAZINE_MAX_SHIFT - SLAB_MIN_SHIFT + 1;
+    static constexpr int MAGAZINE_CAPACITY = 32;        // <= 4 KB 的尺寸类
+    static constexpr int MAGAZINE_LARGE_CAPACITY = 8;   // > 4 KB 的尺寸类，限制每线程缓存的内存
+
+    struct SlabClassStats {
+        size_t block_size = 0;     // 该类可用字节数
+        size_t chunks = 0;         // 已申请的大块数
+        size_t blocks_carved = 0;  // 已从大块切出的块数
+        size_t blocks_in_use = 0;
+        size_t peak_in_use = 0;
+        size_t alloc_count = 0;
+        size_t free_count = 0;
     };
 
     static bool initialize();
@@ -43,6 +77,22 @@ public:
 
     static Stats getStats();
 
+    // 尺寸类统计；直接走 ZRMalloc 的请求数见 getDirectAllocCount
+    static std::array<SlabClassStats, SLAB_CLASS_COUNT> getSlabStats();
+    static size_t getDirectAllocCount();
+    // 运行期开关（默认开启，定义 GLOMEMPOOL_DISABLE_SLAB 则默认关闭）；已分配的块按自身头部记录归还
+    static void setSlabEnabled(bool enable);
+    static bool isSlabEnabled();
+    // size 对应的尺寸类下标，超出范围返回 -1
+    static int sizeClassOf(size_t size);
+    // magazine 开关（默认开启，定义 GLOMEMPOOL_DISABLE_MAGAZINE 则默认关闭）；关闭时排空所有线程的 magazine
+    static void setMagazineEnabled(bool enable);
+    static bool isMagazineEnabled();
+    // 把当前线程 magazine 中的块全部归还 slab（线程退出时自动调用）
+    static void flushThreadCache();
+    // 把所有已登记线程 magazine 中的块全部归还 slab（关闭 magazine 与 finalize 时调用）
+    static void flushAllThreadCaches();
+
     static bool hasPotentialLeak();
     static size_t getOutstandingAllocations();
     static size_t getCurrentBlocks();
@@ -52,11 +102,119 @@ public:
 #endif
 
 private:
+    // 每个分配块前的 16 字节头：记录尺寸类与请求大小，使 deallocate 无需查表即可 O(1) 归还
+    struct BlockHeader {
+        uint32_t magic;
+        int32_t size_class;   // -1 表示直接 ZRMalloc
+        uint64_t size;
+    };
+    static constexpr uint32_t BLOCK_MAGIC = 0x474D5042u; // "GMPB"
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    // 大块链表节点放在大块开头，避免在分配路径上使用标准容器
+    struct alignas(16) ChunkHeader {
+        ChunkHeader* next;
+    };
+
+    struct SlabClass {
+        std::mutex mutex;
+        FreeNode* free_list = nullptr;
+        char* bump = nullptr;        // 当前大块中未切分部分的起点
+        char* bump_end = nullptr;
+        ChunkHeader* chunks = nullptr;
+        SlabClassStats stats;
+    };
+
+    struct Magazine {
+        int count = 0;
+        void* blocks[MAGAZINE_CAPACITY];
+    };
+
+    // 每线程 magazine 登记在 s_cache_head 链表中，供其他线程排空；
+    // busy 由所属线程存取时或排空线程持有，所属线程遇到排空进行中时不等待、直接走 slab
+    struct ThreadCache {
+        Magazine magazines[MAGAZINE_CLASS_COUNT];
+        std::atomic<bool> busy{ false };
+        ThreadCache* prev = nullptr;   // 受 s_cache_registry_mutex 保护
+        ThreadCache* next = nullptr;
+        ThreadCache();
+        ~ThreadCache();
+    };
+
+    static void* slabTakeLocked(int size_class);
+    static void slabPutLocked(int size_class, void* block);
+    static void* slabAllocate(int size_class);
+    static int slabAllocateBatch(int size_class, void** out, int count);
+    static void slabFree(int size_class, BlockHeader* header);
+    static void slabFreeBatch(int size_class, void* const* blocks, int count);
+    static void releaseSlabs();
+
+    static ThreadCache* threadCache();
+    static int magazineCapacity(int size_class);
+    static void* magazinePop(int size_class);
+    static bool magazinePush(int size_class, void* block);
+    static void lockCache(ThreadCache* cache);
+    static void drainCache(ThreadCache* cache);
+
+    // 每线程计数槽：只由所属线程写入（relaxed），读取时汇总所有槽；
+    // 线程退出后槽位可被新线程复用，累计值不清零，因此汇总结果始终精确
+    static constexpr int MAX_COUNTER_SLOTS = 128;  // 最后一个槽为槽位耗尽时的共享槽
+    struct alignas(64) ThreadCounters {
+        std::atomic<bool> in_use{ false };
+        std::atomic<uint64_t> alloc_count{ 0 };
+        std::atomic<uint64_t> dealloc_count{ 0 };
+        std::atomic<uint64_t> bytes_allocated{ 0 };
+        std::atomic<uint64_t> bytes_freed{ 0 };
+        std::atomic<uint64_t> cache_hits{ 0 };
+        std::atomic<uint64_t> cache_misses{ 0 };
+        std::atomic<uint64_t> cache_flushes{ 0 };
+        std::atomic<int64_t> pending_bytes{ 0 };   // 尚未并入 s_usage_bytes 的本线程净分配字节
+    };
+
+    // 每次分配/释放先累积到本线程 pending_bytes，绝对值达到该值才并入全局用量并更新峰值；
+    // 峰值误差不超过 活跃线程数 x PEAK_BATCH_BYTES，快路径不做全局原子操作
+    static constexpr int64_t PEAK_BATCH_BYTES = 64 * 1024;
+
+    static ThreadCounters& localCounters(bool& shared);
+    static void countAlloc(size_t size);
+    static void countFree(size_t size);
+    static void countCache(std::atomic<uint64_t> ThreadCounters::* field);
+    static Stats aggregate();
+    static void refreshPeak();
+    static void addUsage(ThreadCounters& c, bool shared, int64_t delta);
+    static void raisePeak(size_t usage);
+
     static ZRMemPool* s_pool;
-    static Stats s_stats;
+    static ThreadCounters s_counters[MAX_COUNTER_SLOTS];
+    static std::atomic<int> s_counter_high;     // 曾被占用过的最大槽位 + 1
+    static std::atomic<size_t> s_peak_usage;
+    static std::atomic<int64_t> s_usage_bytes;  // 各线程已并入的净分配字节之和
+    static SlabClass s_classes[SLAB_CLASS_COUNT];
+    static std::atomic<size_t> s_direct_allocs;
+    static std::atomic<bool> s_slab_enabled;      // 运行期可切换，分配路径并发读取
+    static std::atomic<bool> s_magazine_enabled;
+    static std::mutex s_cache_registry_mutex;
+    static ThreadCache* s_cache_head;
 
 #ifdef _MEMORY_USE_TRACK_
-    static std::unordered_map<void*, size_t> s_alloc_map;
+    // 分片跟踪表：按指针哈希分到 TRACK_SHARDS 个独立加锁的表，不同线程的分配基本不争用
+    static constexpr int TRACK_SHARDS = 64;
+    struct TrackInfo {
+        size_t size;
+        const char* file;
+        int line;
+    };
+    struct alignas(64) TrackShard {
+        std::mutex mutex;
+        std::unordered_map<void*, TrackInfo> map;
+    };
+    static TrackShard& trackShard(void* ptr);
+    static void trackInsert(void* ptr, size_t size, const char* file, int line);
+    static void trackErase(void* ptr);
+    static TrackShard s_track[TRACK_SHARDS];
 #endif
 
     GloMemPool() = delete;
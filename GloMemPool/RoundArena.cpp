@@ -0,0 +1,172 @@
+﻿// RoundArena.cpp
+#include "RoundArena.h"
+#include "GloMemPool.h"
+
+#include <algorithm>
+
+RoundArena& RoundArena::instance() {
+    static RoundArena arena;
+    return arena;
+}
+
+RoundArena::~RoundArena() {
+    // 程序正常结束时 Main 已调用 release()；此处只处理遗漏的析构函数，不再访问可能已 finalize 的内存池
+    std::lock_guard<std::mutex> lock(mutex_);
+    destructors_ = nullptr;
+}
+
+void* RoundArena::allocate(size_t size, size_t align) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocateLocked(size, align);
+}
+
+void* RoundArena::allocateLocked(size_t size, size_t align) {
+    if (align == 0 || (align & (align - 1)) != 0) {
+        return nullptr;
+    }
+
+    while (current_) {
+        char* base = reinterpret_cast<char*>(current_ + 1);
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(base + offset_);
+        const size_t pad = (align - (addr & (align - 1))) & (align - 1);
+        if (offset_ + pad + size <= current_->size) {
+            void* p = base + offset_ + pad;
+            offset_ += pad + size;
+            allocations_++;
+            const size_t used = used_before_ + offset_;
+            if (used > high_water_) {
+                high_water_ = used;
+            }
+            return p;
+        }
+        if (!current_->next) {
+            break;
+        }
+        // 复用上一轮留下的后续大块
+        used_before_ += offset_;
+        current_ = current_->next;
+        offset_ = 0;
+    }
+
+    // 追加新大块（超大请求单独成块）
+    size_t payload = DEFAULT_CHUNK_BYTES;
+    if (size + align > payload) {
+        payload = size + align;
+    }
+    Chunk* chunk = static_cast<Chunk*>(GloMemPool::allocate(sizeof(Chunk) + payload, __FILE__, __LINE__));
+    if (!chunk) {
+        return nullptr;
+    }
+    chunk->next = nullptr;
+    chunk->size = payload;
+    chunk_count_++;
+    reserved_ += payload;
+
+    if (current_) {
+        used_before_ += offset_;
+        current_->next = chunk;
+    }
+    else {
+        head_ = chunk;
+    }
+    current_ = chunk;
+    offset_ = 0;
+    return allocateLocked(size, align);
+}
+
+void RoundArena::registerDestructor(void* object, void (*destroy)(void*)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    void* mem = allocateLocked(sizeof(DestructorNode), alignof(DestructorNode));
+    if (!mem) {
+        // 无法登记时立即析构会破坏调用方对象，只能放弃析构（内存仍随轮次回收）
+        return;
+    }
+    DestructorNode* node = static_cast<DestructorNode*>(mem);
+    node->destroy = destroy;
+    node->object = object;
+    node->next = destructors_;
+    destructors_ = node;
+}
+
+void RoundArena::resetLocked() {
+    // 后注册的先析构
+    for (DestructorNode* node = destructors_; node; node = node->next) {
+        node->destroy(node->object);
+    }
+    destructors_ = nullptr;
+    current_ = head_;
+    offset_ = 0;
+    used_before_ = 0;
+}
+
+size_t RoundArena::usedLocked() const {
+    return used_before_ + offset_;
+}
+
+size_t RoundArena::used() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usedLocked();
+}
+
+void RoundArena::beginRound(int round, size_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    round_ = round;
+    key_ = key;
+    high_water_ = usedLocked();
+    allocations_ = 0;
+    pool_blocks_at_begin_ = GloMemPool::getCurrentBlocks();
+    chunks_at_begin_ = chunk_count_;
+}
+
+RoundArenaReport RoundArena::endRound() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resetLocked();
+
+    RoundArenaReport report;
+    report.round = round_;
+    report.key = key_;
+    report.high_water = high_water_;
+    report.allocations = allocations_;
+    report.chunks = chunk_count_;
+    report.reserved = reserved_;
+
+    // arena 新增的大块本身也是 GloMemPool 块，不计入泄漏
+    const long long pool_now = static_cast<long long>(GloMemPool::getCurrentBlocks());
+    const long long new_chunks = static_cast<long long>(chunk_count_) - static_cast<long long>(chunks_at_begin_);
+    report.pool_block_delta = pool_now - static_cast<long long>(pool_blocks_at_begin_) - new_chunks;
+
+    // 单轮增长可能来自跨轮保存的结果（如 MetricsReport），连续多轮增长才判为泄漏
+    growth_streak_ = report.pool_block_delta > 0 ? growth_streak_ + 1 : 0;
+    report.pool_leak = growth_streak_ >= LEAK_ROUNDS;
+
+    // arena 中的对象（监听器、长度计划表）与 payload 大小无关，
+    // 与此前各轮的最大高水位比较，长度扫描中每轮 key 都不同时也能发现增长
+    if (!history_.empty()) {
+        const size_t tolerance = (std::max)(max_high_water_ / 10, static_cast<size_t>(4096));
+        report.high_water_growth = report.high_water > max_high_water_ + tolerance;
+    }
+    max_high_water_ = (std::max)(max_high_water_, report.high_water);
+
+    history_.push_back(report);
+    return report;
+}
+
+void RoundArena::release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resetLocked();
+    Chunk* chunk = head_;
+    while (chunk) {
+        Chunk* next = chunk->next;
+        GloMemPool::deallocate(chunk);
+        chunk = next;
+    }
+    head_ = nullptr;
+    current_ = nullptr;
+    chunk_count_ = 0;
+    reserved_ = 0;
+}
+
+std::vector<RoundArenaReport> RoundArena::history() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return history_;
+}
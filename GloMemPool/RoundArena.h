@@ -0,0 +1,123 @@
+﻿// RoundArena.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 单轮测试的线性分配器：轮次内的临时对象（监听器、计划表等）从大块中顺序切出，
+// 轮次结束时 endRound() 一次性回收（运行已注册的析构函数后重置游标），不做逐个释放。
+// 大块在轮次之间保留复用，13 档长度扫描不会在 GloMemPool 中留下碎片。
+struct RoundArenaReport {
+    int round = 0;
+    size_t key = 0;                   // 本轮标识（Main 传入 payload 大小），仅用于报告
+    size_t high_water = 0;            // 本轮 arena 最大占用字节
+    size_t allocations = 0;
+    size_t chunks = 0;                // 轮次结束时持有的大块数
+    size_t reserved = 0;              // 持有的大块总字节
+    long long pool_block_delta = 0;   // 本轮前后 GloMemPool 在用块数之差（已扣除 arena 大块）
+    bool high_water_growth = false;   // 高水位明显超过此前各轮的最大值
+    bool pool_leak = false;           // 连续 LEAK_ROUNDS 轮 GloMemPool 在用块数只增不减
+};
+
+class RoundArena {
+public:
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 64u * 1024u;
+    static constexpr int LEAK_ROUNDS = 3;
+
+    static RoundArena& instance();
+
+    RoundArena(const RoundArena&) = delete;
+    RoundArena& operator=(const RoundArena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    // 在 arena 中构造对象；非平凡析构的对象在 endRound() 时按构造逆序析构
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* mem = allocate(sizeof(T), alignof(T));
+        if (!mem) return nullptr;
+        T* obj = new (mem) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            registerDestructor(obj, [](void* p) { static_cast<T*>(p)->~T(); });
+        }
+        return obj;
+    }
+
+    void beginRound(int round, size_t key);
+    // 析构本轮对象、重置游标（O(1)，大块保留），并做高水位/泄漏比较
+    RoundArenaReport endRound();
+
+    // 释放全部大块（程序结束时调用，须在 GloMemPool::finalize 之前）
+    void release();
+
+    std::vector<RoundArenaReport> history() const;
+    size_t used() const;
+
+private:
+    RoundArena() = default;
+    ~RoundArena();
+
+    struct Chunk {
+        Chunk* next;
+        size_t size;   // 可用字节（不含本头部）
+    };
+
+    struct DestructorNode {
+        DestructorNode* next;
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    void registerDestructor(void* object, void (*destroy)(void*));
+    void* allocateLocked(size_t size, size_t align);
+    void resetLocked();
+    size_t usedLocked() const;
+
+    mutable std::mutex mutex_;
+    Chunk* head_ = nullptr;
+    Chunk* current_ = nullptr;
+    size_t offset_ = 0;          // current_ 中已用字节
+    size_t used_before_ = 0;     // current_ 之前各大块已用字节之和
+    size_t chunk_count_ = 0;
+    size_t reserved_ = 0;
+
+    DestructorNode* destructors_ = nullptr;
+
+    int round_ = 0;
+    size_t key_ = 0;
+    size_t high_water_ = 0;
+    size_t allocations_ = 0;
+    size_t pool_blocks_at_begin_ = 0;
+    size_t chunks_at_begin_ = 0;
+    int growth_streak_ = 0;
+    size_t max_high_water_ = 0;  // 此前各轮高水位的最大值
+
+    std::vector<RoundArenaReport> history_;
+};
+
+// 供标准容器使用的 arena 分配器：deallocate 为空操作，内存在轮次结束时统一回收。
+// 容器必须在 endRound() 之前销毁。
+template<typename T>
+struct RoundArenaAllocator {
+    using value_type = T;
+
+    RoundArenaAllocator() noexcept = default;
+    template<typename U>
+    RoundArenaAllocator(const RoundArenaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        void* p = RoundArena::instance().allocate(n * sizeof(T), alignof(T));
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T*, size_t) noexcept {}
+
+    template<typename U>
+    bool operator==(const RoundArenaAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const RoundArenaAllocator<U>&) const noexcept { return false; }
+};
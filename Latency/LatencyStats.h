@@ -0,0 +1,37 @@
+﻿// LatencyStats.h
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <cstddef>
+
+// 单轮时延统计结果（单位: us，单向时延按 RTT/2 计算）
+struct LatencyStats {
+    size_t count = 0;       // 有效样本数
+    size_t lost = 0;        // 超时未收到回显的 ping 数
+    double min_us = 0.0;
+    double avg_us = 0.0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double p999_us = 0.0;
+    double max_us = 0.0;
+};
+
+// 从直方图汇总（直方图记录单位为 ns，统计结果换算为 us）
+inline LatencyStats computeLatencyStats(const LatencyHistogram& hist) {
+    LatencyStats stats;
+    if (hist.empty()) {
+        return stats;
+    }
+
+    stats.count = static_cast<size_t>(hist.count());
+    stats.min_us = hist.minNs() / 1000.0;
+    stats.max_us = hist.maxNs() / 1000.0;
+    stats.avg_us = hist.meanNs() / 1000.0;
+    stats.p50_us = hist.percentileNs(50.0) / 1000.0;
+    stats.p90_us = hist.percentileNs(90.0) / 1000.0;
+    stats.p99_us = hist.percentileNs(99.0) / 1000.0;
+    stats.p999_us = hist.percentileNs(99.9) / 1000.0;
+    return stats;
+}
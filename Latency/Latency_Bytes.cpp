@@ -0,0 +1,338 @@
+﻿// Latency_Bytes.cpp
+#include "Latency_Bytes.h"
+
+#include "Logger.h"
+#include "ResourceUtilization.h"
+#include "TestRoundResult.h"
+#include "SysMetrics.h"
+
+#include "ZRDDSDataWriter.h"
+#include "ZRDDSDataReader.h"
+#include "ZRBuiltinTypes.h"
+
+#include <memory>
+#include <thread>
+#include <sstream>
+#include <iomanip>
+
+using namespace DDS;
+
+// Packet Header 结构（保持与 DDSManager 版一致，时延测试需要 timestamp）
+struct PacketHeader {
+    uint32_t sequence;     // 序列号
+    uint64_t timestamp;    // 发送时间（纳秒，steady_clock）
+    uint8_t  packet_type;  // 0=数据包, 1=结束包
+};
+
+namespace {
+    // 单个 ping 等待回显的超时时间，超时记为丢失
+    constexpr std::chrono::milliseconds ECHO_TIMEOUT(1000);
+
+    inline uint64_t steadyNowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+// ========================
+// 构造函数 & 析构
+// ========================
+
+Latency_Bytes::Latency_Bytes(DDSManager_Bytes& ddsManager, ResultCallback callback)
+    : ddsManager_(ddsManager)
+    , result_callback_(std::move(callback))
+{
+}
+
+Latency_Bytes::~Latency_Bytes() = default;
+
+// ========================
+// 同步函数
+// ========================
+
+void Latency_Bytes::waitForRoundEnd() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return roundFinished_.load(); });
+}
+
+bool Latency_Bytes::waitForWriterMatch() {
+    auto writer = ddsManager_.get_data_writer();
+    if (!writer) return false;
+
+    while (true) {
+        PublicationMatchedStatus status{};
+        ReturnCode_t ret = writer->get_publication_matched_status(status);
+        if (ret == RETCODE_OK) {
+            Logger::getInstance().logAndPrint(
+                "Writer wait match(" + std::to_string(status.current_count) + "/1)"
+            );
+            if (status.current_count > 0) return true;
+        }
+        else {
+            Logger::getInstance().logAndPrint("Error: Failed to get publication matched status.");
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+bool Latency_Bytes::waitForReaderMatch() {
+    auto reader = ddsManager_.get_data_reader();
+    if (!reader) return false;
+
+    while (true) {
+        SubscriptionMatchedStatus status{};
+        ReturnCode_t ret = reader->get_subscription_matched_status(status);
+        if (ret == RETCODE_OK) {
+            Logger::getInstance().logAndPrint(
+                "Reader wait match(" + std::to_string(status.current_count) + "/1)"
+            );
+            if (status.current_count > 0) return true;
+        }
+        else {
+            Logger::getInstance().logAndPrint("Error: Failed to get subscription matched status.");
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+bool Latency_Bytes::waitForEcho(int64_t sequence, std::chrono::milliseconds timeout, uint64_t& latency_ns) {
+    std::unique_lock<std::mutex> lock(echo_mtx_);
+    const bool echoed = echo_cv_.wait_for(lock, timeout, [this, sequence] {
+        return last_echo_seq_.load(std::memory_order_acquire) == sequence;
+    });
+    if (echoed) {
+        latency_ns = echo_latency_ns_.load(std::memory_order_relaxed);
+    }
+    return echoed;
+}
+
+// ========================
+// runPublisher - 发送 ping 并统计时延
+// ========================
+
+int Latency_Bytes::runPublisher(const ConfigData& config) {
+    using WriterType = DDS::ZRDDSDataWriter<DDS::Bytes>;
+    WriterType* writer = dynamic_cast<WriterType*>(ddsManager_.get_data_writer());
+    if (!writer) {
+        Logger::getInstance().logAndPrint("Latency_Bytes: DataWriter 为空，无法发送");
+        return -1;
+    }
+
+    const int round_index = config.m_activeLoop;
+    const int minSize = config.m_minSize[round_index];
+    const int maxSize = config.m_maxSize[round_index];
+    const int sendCount = config.m_sendCount[round_index];
+    const int sendPrintGap = config.m_sendPrintGap[round_index];
+
+    // ping 需要 Writer 与对端 Reader 匹配，pong 需要回显 Reader 与对端 Writer 匹配
+    if (!waitForWriterMatch() || !waitForReaderMatch()) {
+        Logger::getInstance().logAndPrint("Latency_Bytes: 等待对端匹配失败");
+        return -1;
+    }
+
+    std::ostringstream oss;
+    oss << "第 " << (round_index + 1) << " 轮时延测试 (ping-pong) | 发送: " << sendCount
+        << " 条 | 数据大小: [" << minSize << ", " << maxSize << "]";
+    Logger::getInstance().logAndPrint(oss.str());
+
+    auto& resUtil = ResourceUtilization::instance();
+    resUtil.initialize();
+    SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+
+    // 重置状态（awaited_seq_ 为 -1 时 Listener 不接收回显）
+    {
+        std::lock_guard<std::mutex> lock(echo_mtx_);
+        awaited_seq_.store(-1, std::memory_order_release);
+        last_echo_seq_.store(-1, std::memory_order_release);
+    }
+    // 直方图只由本线程写入（时延经 waitForEcho 取回），Listener 不持锁记录
+    auto histogram = std::make_shared<LatencyHistogram>();
+
+    DDS::Bytes sample;
+    if (!ddsManager_.prepareBytesData(sample, minSize, maxSize, 0, 0)) {
+        Logger::getInstance().logAndPrint("Latency_Bytes: 准备测试数据失败");
+        return -1;
+    }
+
+    uint8_t* buffer = sample.value.get_contiguous_buffer();
+    if (!buffer) {
+        Logger::getInstance().error("Latency_Bytes: 内存 buffer 为空");
+        ddsManager_.cleanupBytesData(sample);
+        return -1;
+    }
+    PacketHeader* hdr = reinterpret_cast<PacketHeader*>(buffer);
+
+    // === ping-pong 主循环：发一条，等回显，再发下一条 ===
+    size_t lost = 0;
+    for (int j = 0; j < sendCount; ++j) {
+        hdr->sequence = static_cast<uint32_t>(j);
+        {
+            // 先登记再发送，避免回显早于登记到达被丢弃
+            std::lock_guard<std::mutex> lock(echo_mtx_);
+            awaited_seq_.store(j, std::memory_order_release);
+        }
+        hdr->timestamp = steadyNowNs();
+
+        DDS::ReturnCode_t ret = writer->write(sample, DDS_HANDLE_NIL_NATIVE);
+        if (ret != DDS::RETCODE_OK) {
+            Logger::getInstance().error("Write failed: " + std::to_string(ret));
+            ++lost;
+            continue;
+        }
+
+        uint64_t latency_ns = 0;
+        if (waitForEcho(j, ECHO_TIMEOUT, latency_ns)) {
+            histogram->record(latency_ns);
+        }
+        else {
+            ++lost;
+        }
+
+        if ((j + 1) % sendPrintGap == 0) {
+            LOG_BIN_PRINT("已发送 {} 条", j + 1);
+        }
+    }
+
+    // 停止接收回显：之后迟到的回显全部丢弃
+    {
+        std::lock_guard<std::mutex> lock(echo_mtx_);
+        awaited_seq_.store(-1, std::memory_order_release);
+    }
+
+    // === 发送结束包 ===
+    ddsManager_.cleanupBytesData(sample);
+    if (ddsManager_.prepareEndBytesData(sample, minSize)) {
+        for (int k = 0; k < 3; ++k) {
+            writer->write(sample, DDS_HANDLE_NIL_NATIVE);
+            Logger::getInstance().logAndPrint("结束包发送第 " + std::to_string(k + 1) + " 次");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ddsManager_.cleanupBytesData(sample);
+
+    // === 统计时延 ===
+    LatencyStats stats = computeLatencyStats(*histogram);
+    stats.lost = lost;
+
+    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    if (result_callback_) {
+        TestRoundResult result{ round_index + 1, start_metrics, end_metrics };
+        result.latency = std::move(histogram);
+        result_callback_(result);
+    }
+
+    std::ostringstream res;
+    res << std::fixed << std::setprecision(2)
+        << "时延测试 (ping-pong) | 第 " << (round_index + 1) << " 轮 | "
+        << "大小: " << minSize << " 字节 | "
+        << "样本: " << stats.count << " | "
+        << "丢失: " << stats.lost << " | "
+        << "min: " << stats.min_us << " us | "
+        << "avg: " << stats.avg_us << " us | "
+        << "p50: " << stats.p50_us << " us | "
+        << "p90: " << stats.p90_us << " us | "
+        << "p99: " << stats.p99_us << " us | "
+        << "p99.9: " << stats.p999_us << " us | "
+        << "max: " << stats.max_us << " us";
+    Logger::getInstance().logAndPrint(res.str());
+
+    return 0;
+}
+
+// ========================
+// runSubscriber - 回显端
+// ========================
+
+int Latency_Bytes::runSubscriber(const ConfigData& config) {
+    if (!ddsManager_.get_data_reader() || !ddsManager_.get_data_writer()) {
+        Logger::getInstance().logAndPrint("Latency_Bytes: 回显端需要 DataReader 与 DataWriter（未启用回显模式？）");
+        return -1;
+    }
+
+    const int round_index = config.m_activeLoop;
+
+    // 重置状态
+    echoedCount_.store(0);
+    roundFinished_.store(false);
+
+    if (!waitForReaderMatch() || !waitForWriterMatch()) {
+        Logger::getInstance().logAndPrint("Latency_Bytes: 等待对端匹配失败");
+        return -1;
+    }
+
+    Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮时延测试开始 (回显端)");
+
+    auto& resUtil = ResourceUtilization::instance();
+    resUtil.initialize();
+    SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+
+    // === 阻塞等待测试结束信号 ===
+    waitForRoundEnd();
+
+    SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    if (result_callback_) {
+        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics });
+    }
+
+    Logger::getInstance().logAndPrint(
+        "时延测试 (回显端) | 第 " + std::to_string(round_index + 1) + " 轮 | 回显: " +
+        std::to_string(echoedCount_.load()) + " 条"
+    );
+
+    return 0;
+}
+
+// ========================
+// 回调函数
+// ========================
+
+void Latency_Bytes::onEchoReceived(const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+    // 先取时间，避免后续处理计入时延
+    const uint64_t now_ns = steadyNowNs();
+    if (!info.valid_data) return;
+
+    const PacketHeader* hdr = reinterpret_cast<const PacketHeader*>(sample.value.get_contiguous_buffer());
+    if (!hdr || now_ns < hdr->timestamp) return;
+
+    // 超时后迟到的回显、上一轮残留的回显：序列号与当前等待的不一致，直接丢弃
+    const int64_t sequence = static_cast<int64_t>(hdr->sequence);
+    if (sequence != awaited_seq_.load(std::memory_order_acquire)) return;
+    const uint64_t latency_ns = (now_ns - hdr->timestamp) / 2;
+    {
+        // 加锁后再确认一次：发送线程可能刚好超时并切换到下一条；锁内只发布时延与序列号
+        std::lock_guard<std::mutex> lock(echo_mtx_);
+        if (sequence != awaited_seq_.load(std::memory_order_relaxed)) return;
+        echo_latency_ns_.store(latency_ns, std::memory_order_relaxed);
+        last_echo_seq_.store(sequence, std::memory_order_release);
+    }
+    echo_cv_.notify_one();
+}
+
+void Latency_Bytes::onDataReceived(const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+    if (!info.valid_data) return;
+
+    // 回显 Writer 每轮随 DDSManager 重建，首个样本到达时再解析并缓存
+    EchoWriterType* writer = echo_writer_.load(std::memory_order_acquire);
+    if (!writer) {
+        writer = dynamic_cast<EchoWriterType*>(ddsManager_.get_data_writer());
+        if (!writer) return;
+        echo_writer_.store(writer, std::memory_order_release);
+    }
+
+    // 原样回写，header 中的 timestamp 由发送端解析
+    if (writer->write(sample, DDS_HANDLE_NIL_NATIVE) == DDS::RETCODE_OK) {
+        echoedCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Latency_Bytes::onEndOfRound() {
+    // 本轮结束后 Writer 即将随 shutdown 销毁
+    echo_writer_.store(nullptr, std::memory_order_release);
+
+    roundFinished_.store(true);
+    cv_.notify_one();
+
+    Logger::getInstance().logAndPrint("[Latency_Bytes] 测试轮次结束信号已触发");
+}
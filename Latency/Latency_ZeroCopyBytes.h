@@ -0,0 +1,67 @@
+﻿// Latency_ZeroCopyBytes.h
+#pragma once
+
+#include "DDSManager_ZeroCopyBytes.h"
+#include "ZRDDSDataWriter.h"
+#include "LatencyStats.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+struct TestRoundResult;
+
+// ping-pong 时延测试（DDS::ZeroCopyBytes，零拷贝）
+// 发送端在 PacketHeader::timestamp 中打上发送时刻，接收端在回显 Topic 上原样回写，
+// 发送端收到回显后按 RTT/2 记录单向时延。
+class Latency_ZeroCopyBytes {
+public:
+    using ResultCallback = std::function<void(const TestRoundResult&)>;
+
+    explicit Latency_ZeroCopyBytes(DDSManager_ZeroCopyBytes& ddsManager, ResultCallback callback = nullptr);
+    ~Latency_ZeroCopyBytes();
+
+    int runPublisher(const ConfigData& config);
+    int runSubscriber(const ConfigData& config);
+
+    // 发送端：收到回显
+    void onEchoReceived(const DDS::ZeroCopyBytes& sample, const DDS::SampleInfo& info);
+    // 接收端：收到 ping，立即回显
+    void onDataReceived(const DDS::ZeroCopyBytes& sample, const DDS::SampleInfo& info);
+    void onEndOfRound();
+
+private:
+    DDSManager_ZeroCopyBytes& ddsManager_;
+    ResultCallback result_callback_;
+
+    // 发送端：回显同步
+    // 只有序列号等于 awaited_seq_ 的回显才会被记录；迟到或上一轮的回显直接丢弃
+    std::atomic<uint64_t> echo_latency_ns_{ 0 }; // 最近一次匹配回显的单向时延（ns），与 last_echo_seq_ 一同在 echo_mtx_ 内发布
+    std::atomic<int64_t> awaited_seq_{ -1 };   // 正在等待的序列号，-1 表示不接收回显
+    std::atomic<int64_t> last_echo_seq_{ -1 }; // 最近一次匹配成功的回显序列号
+    std::mutex echo_mtx_;
+    std::condition_variable echo_cv_;
+
+    // 接收端：回显 Writer（缓存 dynamic_cast 结果，避免逐样本转换）
+    using EchoWriterType = DDS::ZRDDSDataWriter<DDS::ZeroCopyBytes>;
+    std::atomic<EchoWriterType*> echo_writer_{ nullptr };
+
+    // 接收端：回显样本（复用 manager 的零拷贝缓冲区，只改写 header）
+    DDS::ZeroCopyBytes echo_sample_{};
+    std::atomic<bool> echo_ready_{ false };
+
+    // 接收端：轮次结束同步
+    std::atomic<int> echoedCount_{ 0 };
+    std::atomic<bool> roundFinished_{ false };
+    std::mutex mtx_;
+    std::condition_variable cv_;
+
+    void waitForRoundEnd();
+    bool waitForWriterMatch();
+    bool waitForReaderMatch();
+    // 等到序列号为 sequence 的回显时返回 true，并取出其单向时延
+    bool waitForEcho(int64_t sequence, std::chrono::milliseconds timeout, uint64_t& latency_ns);
+};
@@ -0,0 +1,35 @@
+﻿// LogDecoder.cpp
+// 把二进制日志（GlobalConfig::LOG_BINARY_OUTPUT 开启时生成的 .bin）还原为文本日志
+// 用法：LogDecoder <输入.bin> [输出.log]，省略输出文件时打印到控制台
+#include "BinaryLog.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "用法: LogDecoder <输入.bin> [输出.log]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream file;
+    if (argc >= 3) {
+        file.open(argv[2], std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "[Error] 无法创建输出文件: " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::string error;
+    if (!BinaryLog::decodeFile(argv[1], argc >= 3 ? static_cast<std::ostream&>(file) : std::cout, error)) {
+        std::cerr << "[Error] " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (argc >= 3) {
+        std::cout << "已解码: " << argv[1] << " -> " << argv[2] << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
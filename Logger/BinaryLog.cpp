@@ -0,0 +1,247 @@
+﻿// BinaryLog.cpp
+#include "BinaryLog.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <unordered_map>
+
+BinaryLog::FormatInfo BinaryLog::s_formats[BinaryLog::MAX_FORMATS];
+std::atomic<uint32_t> BinaryLog::s_format_count{ 0 };
+
+namespace {
+    constexpr char FILE_MAGIC[8] = { 'Z', 'R', 'L', 'O', 'G', 'B', 'I', 'N' };
+    constexpr size_t RECORD_HEADER_BYTES = sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint8_t);
+
+    template<typename T>
+    bool readPod(const char*& p, const char* end, T& value) {
+        if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    // 读取第 index 个参数的文本表示
+    bool formatNextArg(const char*& p, const char* end, std::string& out) {
+        uint8_t type = 0;
+        if (!readPod(p, end, type)) return false;
+        char buf[64];
+        switch (type) {
+        case BinaryLog::ARG_I64: {
+            int64_t v = 0;
+            if (!readPod(p, end, v)) return false;
+            std::snprintf(buf, sizeof(buf), "%" PRId64, v);
+            out.append(buf);
+            return true;
+        }
+        case BinaryLog::ARG_U64: {
+            uint64_t v = 0;
+            if (!readPod(p, end, v)) return false;
+            std::snprintf(buf, sizeof(buf), "%" PRIu64, v);
+            out.append(buf);
+            return true;
+        }
+        case BinaryLog::ARG_F64: {
+            double v = 0.0;
+            if (!readPod(p, end, v)) return false;
+            std::snprintf(buf, sizeof(buf), "%.6g", v);
+            out.append(buf);
+            return true;
+        }
+        case BinaryLog::ARG_STR: {
+            uint16_t n = 0;
+            if (!readPod(p, end, n) || static_cast<size_t>(end - p) < n) return false;
+            out.append(p, n);
+            p += n;
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+}
+
+BinaryLog::ClockAnchor BinaryLog::ClockAnchor::now() {
+    ClockAnchor anchor;
+    anchor.steady_ticks = static_cast<int64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    anchor.system_ns = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    anchor.period_num = static_cast<int64_t>(std::chrono::steady_clock::period::num);
+    anchor.period_den = static_cast<int64_t>(std::chrono::steady_clock::period::den);
+    return anchor;
+}
+
+uint32_t BinaryLog::registerFormat(const char* format, const char* file, int line) {
+    const uint32_t index = s_format_count.fetch_add(1, std::memory_order_relaxed);
+    if (index >= MAX_FORMATS - 1) {
+        return 0;
+    }
+    // id 从 1 开始，0 保留为无效；表项在返回 id 前写好，之后经日志环的 release/acquire 对后台线程可见
+    s_formats[index + 1] = FormatInfo{ format, file, line };
+    return index + 1;
+}
+
+const BinaryLog::FormatInfo* BinaryLog::formatInfo(uint32_t id) {
+    if (id == 0 || id >= MAX_FORMATS || s_formats[id].format == nullptr) {
+        return nullptr;
+    }
+    return &s_formats[id];
+}
+
+bool BinaryLog::parseHeader(const char* data, size_t len, uint32_t& format_id, int64_t& tick) {
+    if (len < RECORD_HEADER_BYTES) return false;
+    std::memcpy(&format_id, data, sizeof(format_id));
+    std::memcpy(&tick, data + sizeof(format_id), sizeof(tick));
+    return true;
+}
+
+void BinaryLog::formatArgs(const char* format, const char* data, size_t len, std::string& out) {
+    out.clear();
+    if (len < RECORD_HEADER_BYTES) return;
+    const char* p = data + RECORD_HEADER_BYTES;
+    const char* end = data + len;
+    uint8_t argc = 0;
+    std::memcpy(&argc, data + sizeof(uint32_t) + sizeof(int64_t), sizeof(argc));
+
+    uint8_t used = 0;
+    for (const char* f = format ? format : ""; *f; ++f) {
+        if (f[0] == '{' && f[1] == '}' && used < argc && formatNextArg(p, end, out)) {
+            ++used;
+            ++f;
+            continue;
+        }
+        out.push_back(*f);
+    }
+    // 参数多于占位符时追加在末尾
+    while (used < argc) {
+        out.push_back(' ');
+        if (!formatNextArg(p, end, out)) break;
+        ++used;
+    }
+}
+
+std::string BinaryLog::formatWallClock(int64_t tick, const ClockAnchor& anchor) {
+    const long double delta_ns = static_cast<long double>(tick - anchor.steady_ticks) *
+        anchor.period_num * 1000000000.0L / anchor.period_den;
+    const int64_t wall_ns = anchor.system_ns + static_cast<int64_t>(delta_ns);
+    const std::time_t seconds = static_cast<std::time_t>(wall_ns / 1000000000);
+    const int millisecond = static_cast<int>((wall_ns / 1000000) % 1000);
+
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, millisecond);
+    return buf;
+}
+
+void BinaryLog::appendFileHeader(std::string& out, const ClockAnchor& anchor) {
+    const uint32_t version = FILE_VERSION;
+    out.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+    out.append(reinterpret_cast<const char*>(&version), sizeof(version));
+    appendFileRecord(out, FILE_ANCHOR, reinterpret_cast<const char*>(&anchor), sizeof(anchor));
+}
+
+void BinaryLog::appendFileRecord(std::string& out, uint8_t type, const char* data, size_t len) {
+    const uint32_t n = static_cast<uint32_t>(len);
+    out.push_back(static_cast<char>(type));
+    out.append(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.append(data, len);
+}
+
+void BinaryLog::appendFormatRecord(std::string& out, uint32_t id) {
+    const FormatInfo* info = formatInfo(id);
+    if (!info) return;
+    const std::string file = info->file ? info->file : "";
+    const int32_t line = info->line;
+    const uint16_t file_len = static_cast<uint16_t>(file.size() < 0xFFFF ? file.size() : 0xFFFF);
+
+    std::string payload;
+    payload.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    payload.append(reinterpret_cast<const char*>(&line), sizeof(line));
+    payload.append(reinterpret_cast<const char*>(&file_len), sizeof(file_len));
+    payload.append(file, 0, file_len);
+    payload.append(info->format);
+    appendFileRecord(out, FILE_FORMAT, payload.data(), payload.size());
+}
+
+bool BinaryLog::decodeFile(const std::string& path, std::ostream& out, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "无法打开二进制日志: " + path;
+        return false;
+    }
+
+    char magic[sizeof(FILE_MAGIC)];
+    uint32_t version = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!in || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) {
+        error = "不是二进制日志文件: " + path;
+        return false;
+    }
+    if (version != FILE_VERSION) {
+        error = "不支持的二进制日志版本: " + std::to_string(version);
+        return false;
+    }
+
+    ClockAnchor anchor;
+    std::unordered_map<uint32_t, std::string> formats;
+    std::string payload;
+    std::string text;
+
+    while (true) {
+        uint8_t type = 0;
+        uint32_t len = 0;
+        if (!in.read(reinterpret_cast<char*>(&type), 1)) break;
+        if (!in.read(reinterpret_cast<char*>(&len), sizeof(len))) {
+            error = "记录头不完整（文件可能被截断）";
+            return false;
+        }
+        payload.resize(len);
+        if (len > 0 && !in.read(&payload[0], len)) {
+            error = "记录内容不完整（文件可能被截断）";
+            return false;
+        }
+
+        switch (type) {
+        case FILE_ANCHOR:
+            if (len == sizeof(anchor)) {
+                std::memcpy(&anchor, payload.data(), sizeof(anchor));
+            }
+            break;
+        case FILE_FORMAT: {
+            const size_t fixed = sizeof(uint32_t) + sizeof(int32_t) + sizeof(uint16_t);
+            if (len < fixed) break;
+            uint32_t id = 0;
+            uint16_t file_len = 0;
+            std::memcpy(&id, payload.data(), sizeof(id));
+            std::memcpy(&file_len, payload.data() + sizeof(uint32_t) + sizeof(int32_t), sizeof(file_len));
+            if (fixed + file_len <= len) {
+                formats[id] = payload.substr(fixed + file_len);
+            }
+            break;
+        }
+        case FILE_TEXT:
+            out << payload << '\n';
+            break;
+        case FILE_BINARY: {
+            uint32_t id = 0;
+            int64_t tick = 0;
+            if (!parseHeader(payload.data(), payload.size(), id, tick)) break;
+            auto it = formats.find(id);
+            formatArgs(it != formats.end() ? it->second.c_str() : "<未知格式>", payload.data(), payload.size(), text);
+            out << "[LOG] " << formatWallClock(tick, anchor) << " " << text << '\n';
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return true;
+}
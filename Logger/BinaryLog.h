@@ -0,0 +1,140 @@
+﻿// BinaryLog.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// 二进制日志记录：调用线程只写入格式 id、steady_clock 原始计数和 POD 参数，
+// 字符串拼接、数值格式化与墙上时间换算全部推迟到后台线程或离线解码工具（LogDecoder）。
+//
+// 记录布局：u32 格式 id | i64 steady 计数 | u8 参数个数 | 参数...
+// 参数布局：u8 类型 | 值（i64/u64/f64 为 8 字节；字符串为 u16 长度 + 字节）
+class BinaryLog {
+public:
+    static constexpr uint32_t MAX_FORMATS = 4096;
+    static constexpr size_t MAX_RECORD_BYTES = 512;
+    static constexpr size_t MAX_STRING_ARG = 200;    // 字符串参数超出部分截断
+
+    enum ArgType : uint8_t { ARG_I64 = 1, ARG_U64 = 2, ARG_F64 = 3, ARG_STR = 4 };
+
+    struct FormatInfo {
+        const char* format;   // 使用 "{}" 作为占位符
+        const char* file;
+        int line;
+    };
+
+    // steady_clock 与 system_clock 的对应关系，用于把 steady 计数换算为墙上时间
+    struct ClockAnchor {
+        int64_t system_ns = 0;
+        int64_t steady_ticks = 0;
+        int64_t period_num = 1;
+        int64_t period_den = 1;
+        static ClockAnchor now();
+    };
+
+    // 注册格式串（通常由 LOG_BIN 宏在首次执行时调用），返回从 1 开始的 id；表满时返回 0
+    static uint32_t registerFormat(const char* format, const char* file, int line);
+    static const FormatInfo* formatInfo(uint32_t id);
+
+    class Encoder {
+    public:
+        Encoder(char* buffer, size_t capacity) : begin_(buffer), cur_(buffer), end_(buffer + capacity) {}
+
+        void begin(uint32_t format_id, int64_t tick, uint8_t argc) {
+            write(&format_id, sizeof(format_id));
+            write(&tick, sizeof(tick));
+            write(&argc, sizeof(argc));
+        }
+
+        template<typename T>
+        void put(const T& value) {
+            using U = std::decay_t<T>;
+            if constexpr (std::is_same_v<U, bool>) {
+                putU64(value ? 1 : 0);
+            }
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+                const int64_t v = static_cast<int64_t>(value);
+                putTagged(ARG_I64, &v, sizeof(v));
+            }
+            else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+                putU64(static_cast<uint64_t>(value));
+            }
+            else if constexpr (std::is_floating_point_v<U>) {
+                const double v = static_cast<double>(value);
+                putTagged(ARG_F64, &v, sizeof(v));
+            }
+            else if constexpr (std::is_same_v<U, std::string>) {
+                putString(value.data(), value.size());
+            }
+            else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+                putString(value, value ? std::strlen(value) : 0);
+            }
+            else {
+                static_assert(std::is_arithmetic_v<U>, "LOG_BIN 只支持整数、浮点、字符串参数");
+            }
+        }
+
+        size_t size() const { return static_cast<size_t>(cur_ - begin_); }
+
+    private:
+        void write(const void* data, size_t len) {
+            if (static_cast<size_t>(end_ - cur_) < len) {
+                cur_ = end_;   // 超长记录：后续参数丢弃，解码时按已有参数输出
+                return;
+            }
+            std::memcpy(cur_, data, len);
+            cur_ += len;
+        }
+        void putTagged(uint8_t type, const void* data, size_t len) {
+            if (static_cast<size_t>(end_ - cur_) < len + 1) {
+                cur_ = end_;
+                return;
+            }
+            write(&type, 1);
+            write(data, len);
+        }
+        void putU64(uint64_t v) { putTagged(ARG_U64, &v, sizeof(v)); }
+        void putString(const char* s, size_t len) {
+            const uint16_t n = static_cast<uint16_t>(len < MAX_STRING_ARG ? len : MAX_STRING_ARG);
+            if (static_cast<size_t>(end_ - cur_) < 3u + n) {
+                cur_ = end_;
+                return;
+            }
+            const uint8_t type = ARG_STR;
+            write(&type, 1);
+            write(&n, sizeof(n));
+            write(s, n);
+        }
+
+        char* begin_;
+        char* cur_;
+        char* end_;
+    };
+
+    // 读取记录头；记录过短时返回 false
+    static bool parseHeader(const char* data, size_t len, uint32_t& format_id, int64_t& tick);
+    // 按格式串依次替换 "{}" 占位符（不含时间前缀）；多余参数追加在末尾，缺少的保留 "{}"
+    static void formatArgs(const char* format, const char* data, size_t len, std::string& out);
+    // steady 计数 -> "YYYY-MM-DD HH:MM:SS.mmm"
+    static std::string formatWallClock(int64_t tick, const ClockAnchor& anchor);
+
+    // 二进制日志文件：文件头 "ZRLOGBIN" + u32 版本，之后每条为 u8 类型 + u32 长度 + 内容
+    enum FileRecordType : uint8_t { FILE_ANCHOR = 1, FILE_FORMAT = 2, FILE_TEXT = 3, FILE_BINARY = 4 };
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    static void appendFileHeader(std::string& out, const ClockAnchor& anchor);
+    static void appendFileRecord(std::string& out, uint8_t type, const char* data, size_t len);
+    // 格式表项（id、行号、文件、格式串），解码工具据此还原文本
+    static void appendFormatRecord(std::string& out, uint32_t id);
+
+    // 离线解码：把 .bin 还原为与文本模式相同的日志行
+    static bool decodeFile(const std::string& path, std::ostream& out, std::string& error);
+
+private:
+    static FormatInfo s_formats[MAX_FORMATS];
+    static std::atomic<uint32_t> s_format_count;
+};
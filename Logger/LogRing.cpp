@@ -0,0 +1,97 @@
+﻿// LogRing.cpp
+#include "LogRing.h"
+#include <cstring>
+#include <thread>
+
+LogRing::LogRing(size_t capacity) {
+    size_t cap = MAX_RECORDS_PER_MESSAGE;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    cells_.reset(new Cell[cap]);
+    mask_ = cap - 1;
+    for (size_t i = 0; i < cap; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+LogRing::~LogRing() = default;
+
+bool LogRing::tryPush(uint8_t kind, const char* data, size_t len, bool mark_truncation) {
+    size_t records = len == 0 ? 1 : (len + PAYLOAD_BYTES - 1) / PAYLOAD_BYTES;
+    // 逻辑内容 = data 的前 keep 字节 + 截断标记（未截断时 keep == len，无标记）
+    size_t keep = len;
+    size_t marker_len = 0;
+    const bool truncated = records > MAX_RECORDS_PER_MESSAGE;
+    if (truncated) {
+        records = MAX_RECORDS_PER_MESSAGE;
+        len = MAX_MESSAGE_BYTES;
+        marker_len = mark_truncation ? sizeof(TRUNCATION_MARKER) - 1 : 0;
+        keep = len - marker_len;
+    }
+
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        // 消费者按顺序释放槽位，整段中最后一个槽空闲则前面的槽必然空闲
+        const size_t last = pos + records - 1;
+        const size_t seq = cells_[last & mask_].sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(last);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + records, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return false;   // 已满
+        }
+        else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    if (truncated) {
+        truncated_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < records; ++i) {
+        Cell& cell = cells_[(pos + i) & mask_];
+        const size_t offset = i * PAYLOAD_BYTES;
+        const size_t n = (len - offset < PAYLOAD_BYTES) ? len - offset : PAYLOAD_BYTES;
+        size_t copied = 0;
+        if (offset < keep) {
+            copied = (keep - offset < n) ? keep - offset : n;
+            std::memcpy(cell.payload, data + offset, copied);
+        }
+        if (copied < n) {
+            std::memcpy(cell.payload + copied, TRUNCATION_MARKER + (offset + copied - keep), n - copied);
+        }
+        cell.length = static_cast<uint16_t>(n);
+        cell.kind = kind;
+        cell.more = (i + 1 < records) ? 1 : 0;
+        cell.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+bool LogRing::tryPop(uint8_t& kind, std::string& out) {
+    Cell* cell = &cells_[dequeue_pos_ & mask_];
+    if (cell->sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+        return false;
+    }
+
+    out.clear();
+    kind = cell->kind;
+    for (;;) {
+        out.append(cell->payload, cell->length);
+        const bool more = cell->more != 0;
+        cell->sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_pos_;
+        if (!more) {
+            return true;
+        }
+        // 同一条消息的后续槽已被生产者领取，正在写入中，短暂等待发布
+        cell = &cells_[dequeue_pos_ & mask_];
+        while (cell->sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+            std::this_thread::yield();
+        }
+    }
+}
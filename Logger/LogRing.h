@@ -0,0 +1,53 @@
+﻿// LogRing.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 有界无锁多生产者/单消费者环形缓冲区（基于逐槽序号的 Vyukov 有界队列）。
+// 记录为预分配的定长 256 字节槽，一条消息超过单槽容量时连续占用多个槽，
+// 生产者一次 CAS 领取整段槽位，入队路径不加锁、不分配内存。
+class LogRing {
+public:
+    static constexpr size_t RECORD_BYTES = 256;
+    static constexpr size_t PAYLOAD_BYTES = RECORD_BYTES - 16;
+    static constexpr size_t MAX_RECORDS_PER_MESSAGE = 64;   // 单条消息上限约 15 KB，超出截断
+    static constexpr size_t MAX_MESSAGE_BYTES = MAX_RECORDS_PER_MESSAGE * PAYLOAD_BYTES;
+    static constexpr char TRUNCATION_MARKER[] = "...[已截断]";   // 截断的文本消息以此结尾
+
+    // capacity 向上取整为 2 的幂（记录数）
+    explicit LogRing(size_t capacity);
+    ~LogRing();
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // 写入一条消息；空间不足时返回 false（由调用方决定丢弃或重试）。
+    // 超过 MAX_MESSAGE_BYTES 时截断并计数，mark_truncation 为 true 时末尾替换为 TRUNCATION_MARKER
+    bool tryPush(uint8_t kind, const char* data, size_t len, bool mark_truncation = true);
+
+    // 仅限消费者线程：取出下一条完整消息（覆盖 out），无数据时返回 false
+    bool tryPop(uint8_t& kind, std::string& out);
+
+    size_t capacity() const { return mask_ + 1; }
+    // 已写入但被截断的消息数
+    uint64_t truncatedCount() const { return truncated_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        uint16_t length;
+        uint8_t kind;
+        uint8_t more;        // 1 = 后续槽属于同一条消息
+        char payload[PAYLOAD_BYTES];
+    };
+    static_assert(sizeof(Cell) == RECORD_BYTES, "LogRing::Cell 必须为 256 字节");
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueue_pos_{ 0 };
+    alignas(64) size_t dequeue_pos_ = 0;   // 只由消费者访问
+    std::atomic<uint64_t> truncated_{ 0 };
+};
@@ -1,18 +1,26 @@
 ﻿// Logger.cpp
 #include "Logger.h"
+#include "LogRing.h"
+#include "BinaryLog.h"
+#include <unordered_map>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <filesystem>
 #include <mutex>
-#include <queue>
 #include <thread>
-#include <condition_variable>
 #include <atomic>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <ctime>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 // Logger 的内部实现类
 class Logger::Impl {
@@ -21,16 +29,49 @@ public:
     std::string log_directory_;                      // 日志目录
     std::string log_file_prefix_ = "log_";          // 日志文件名前缀
     std::string log_file_suffix_ = ".log";          // 日志文件名后缀
-    bool isInitialized_ = false;                     // 是否已初始化
+    std::atomic<bool> isInitialized_{ false };       // 是否已初始化
     mutable std::atomic<int> file_counter_{ 0 };    // 用于生成唯一文件名的原子计数器
 
-    // 日志队列，用于异步写入
-    std::queue<std::string> log_queue_;
-    std::mutex queue_mutex_;                        // 保护日志队列的互斥锁
-    std::condition_variable cv_;                    // 条件变量，用于通知写入线程
+    // 日志环形缓冲区（无锁多生产者），后台线程批量写入
+    static constexpr size_t RING_RECORDS = 16384;                 // 16384 x 256 B = 4 MB
+    static constexpr size_t WRITE_BATCH = 512;                    // 每批最多取出的消息数
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;              // 累计写入超过该值即 flush
+    static constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(200);
+    static constexpr auto IDLE_SLEEP = std::chrono::milliseconds(1);
+
+    enum RecordKind : uint8_t {
+        KIND_TEXT = 0,
+        KIND_URGENT = 1,   // ERROR 等需要尽快落盘的行
+        KIND_BINARY = 2,   // 延迟格式化记录（LOG_BIN）
+        KIND_CONSOLE = 0x10,   // 标志位：同时由后台线程打印到控制台；文本记录以 u16 偏移开头，指向控制台文本
+        KIND_BINARY_PRINT = KIND_BINARY | KIND_CONSOLE,
+    };
+
+    // 控制台输出：由后台线程合并写出；按"消息位置"限速，超出部分只保留最后一条并计数
+    static constexpr uint32_t CONSOLE_LINES_PER_SECOND = 20;     // 每个位置每秒最多打印的行数
+    static constexpr auto CONSOLE_WINDOW = std::chrono::seconds(1);
+    static constexpr size_t CONSOLE_MAX_SITES = 1024;
+    static constexpr uint64_t CONSOLE_SITE_UNLIMITED = ~0ULL;   // printReport 使用的位置键，不限速
+
+    struct ConsoleSite {
+        std::chrono::steady_clock::time_point window_start;
+        uint32_t printed = 0;
+        uint32_t suppressed = 0;
+        std::string last;                              // 最近一条被合并的输出
+    };
+
+    LogRing ring_{ RING_RECORDS };
+    std::atomic<int> overflow_policy_{ static_cast<int>(Logger::OverflowPolicy::Block) };
+    std::atomic<uint64_t> dropped_{ 0 };            // Drop 策略下被丢弃的消息数
     std::atomic<bool> stop_{ false };               // 停止标志
     std::thread writer_thread_;                     // 后台写入线程
 
+    std::atomic<bool> binary_output_{ false };      // 是否输出 .bin 二进制日志
+    BinaryLog::ClockAnchor anchor_;                 // 初始化时记录的时钟锚点，用于换算 LOG_BIN 的时间
+
+    std::atomic<uint32_t> console_rate_{ CONSOLE_LINES_PER_SECOND };   // 0 = 不限速
+    std::unordered_map<uint64_t, ConsoleSite> console_sites_;         // 仅后台线程访问
+
     // 结构体，用于处理和格式化时间戳
     struct LogTimestamp {
         int year, month, day, hour, minute, second, millisecond;
@@ -121,47 +162,272 @@ public:
         return (std::filesystem::path(log_directory_) / oss.str()).string();
     }
 
-    // 后台写入线程函数
+    // 调用位置键：文件名 + 行号做 FNV-1a；最高位留给 LOG_BIN 格式 id，0 表示未知位置
+    static uint64_t siteKey(const char* file, int line) {
+        if (!file || line <= 0) return 0;
+        uint64_t hash = 1469598103934665603ULL;
+        for (const char* p = file; *p; ++p) {
+            hash = (hash ^ static_cast<unsigned char>(*p)) * 1099511628211ULL;
+        }
+        hash = (hash ^ static_cast<uint64_t>(line)) * 1099511628211ULL;
+        hash &= ~(1ULL << 63);
+        return hash ? hash : 1;
+    }
+
+    // 未知调用位置时的文本键：忽略数字后做 FNV-1a，"已发送 100 条" 与 "已发送 200 条" 视为同一位置
+    static uint64_t consoleKey(const char* text, size_t len) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (size_t i = 0; i < len; ++i) {
+            const unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c >= '0' && c <= '9') continue;
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // 把被合并的最后一条输出连同计数补打出来
+    static void flushConsoleSite(ConsoleSite& site, std::string& console) {
+        if (site.suppressed == 0) return;
+        console.append(site.last);
+        console.append("  [Logger] 另有 " + std::to_string(site.suppressed) + " 条相似输出已合并\n");
+        site.suppressed = 0;
+        site.last.clear();
+    }
+
+    void appendConsole(uint64_t key, const char* text, size_t len, std::string& console,
+        std::chrono::steady_clock::time_point now) {
+        const uint32_t limit = console_rate_.load(std::memory_order_relaxed);
+        if (limit == 0 || key == CONSOLE_SITE_UNLIMITED) {
+            console.append(text, len);
+            console.push_back('\n');
+            return;
+        }
+        if (console_sites_.size() >= CONSOLE_MAX_SITES && console_sites_.find(key) == console_sites_.end()) {
+            flushConsoleSites(now, console, true);
+        }
+        ConsoleSite& site = console_sites_[key];
+        if (now - site.window_start >= CONSOLE_WINDOW) {
+            flushConsoleSite(site, console);
+            site.window_start = now;
+            site.printed = 0;
+        }
+        if (site.printed < limit) {
+            ++site.printed;
+            console.append(text, len);
+            console.push_back('\n');
+        }
+        else {
+            ++site.suppressed;
+            site.last.assign(text, len);
+        }
+    }
+
+    // 窗口到期（或 all 为 true）时补打被合并的输出；all 同时清空位置表
+    void flushConsoleSites(std::chrono::steady_clock::time_point now, std::string& console, bool all) {
+        for (auto& entry : console_sites_) {
+            if (all || now - entry.second.window_start >= CONSOLE_WINDOW) {
+                flushConsoleSite(entry.second, console);
+            }
+        }
+        if (all) {
+            console_sites_.clear();
+        }
+    }
+
+    // 把一条取出的记录追加到写入批次：文本模式下解码 LOG_BIN 记录，二进制模式下原样写出
+    void appendRecord(uint8_t kind, const std::string& record, std::string& batch, std::string& console,
+        std::string& text, std::vector<bool>& formats_written, std::chrono::steady_clock::time_point now) {
+        const bool binary = binary_output_.load(std::memory_order_relaxed);
+        const bool print = (kind & KIND_CONSOLE) != 0;
+        if ((kind & ~KIND_CONSOLE) != KIND_BINARY) {
+            const char* line = record.data();
+            size_t length = record.size();
+            if (print) {
+                uint16_t offset = 0;
+                uint64_t site = 0;
+                if (length < sizeof(offset) + sizeof(site)) return;
+                std::memcpy(&offset, line, sizeof(offset));
+                std::memcpy(&site, line + sizeof(offset), sizeof(site));
+                line += sizeof(offset) + sizeof(site);
+                length -= sizeof(offset) + sizeof(site);
+                if (offset > length) offset = 0;
+                const uint64_t key = site != 0 ? site : consoleKey(line + offset, length - offset);
+                appendConsole(key, line + offset, length - offset, console, now);
+            }
+            if (!isInitialized_) return;   // 日志未启用时只打印控制台
+            if (binary) {
+                BinaryLog::appendFileRecord(batch, BinaryLog::FILE_TEXT, line, length);
+            }
+            else {
+                batch.append(line, length);
+                batch.push_back('\n');
+            }
+            return;
+        }
+
+        uint32_t id = 0;
+        int64_t tick = 0;
+        if (!BinaryLog::parseHeader(record.data(), record.size(), id, tick)) return;
+        const BinaryLog::FormatInfo* info = BinaryLog::formatInfo(id);
+        if (!info) return;
+
+        if (print || !binary) {
+            BinaryLog::formatArgs(info->format, record.data(), record.size(), text);
+        }
+        if (print) {
+            // LOG_BIN 的格式 id 本身就是调用位置；最高位区分于文本消息的哈希键
+            appendConsole((1ULL << 63) | id, text.data(), text.size(), console, now);
+        }
+        if (binary) {
+            if (!formats_written[id]) {
+                BinaryLog::appendFormatRecord(batch, id);
+                formats_written[id] = true;
+            }
+            BinaryLog::appendFileRecord(batch, BinaryLog::FILE_BINARY, record.data(), record.size());
+        }
+        else {
+            batch.append("[LOG] ");
+            batch.append(BinaryLog::formatWallClock(tick, anchor_));
+            batch.push_back(' ');
+            batch.append(text);
+            batch.push_back('\n');
+        }
+    }
+
+    // 设置当前线程的系统线程名，便于资源统计与调试器中识别日志线程
+    static void setCurrentThreadName(const char* name) {
+#ifdef _WIN32
+        using SetThreadDescriptionFn = HRESULT(WINAPI*)(HANDLE, PCWSTR);
+        const SetThreadDescriptionFn set_description = reinterpret_cast<SetThreadDescriptionFn>(
+            GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+        if (set_description) {
+            std::wstring wide(name, name + std::strlen(name));
+            set_description(GetCurrentThread(), wide.c_str());
+        }
+#else
+        pthread_setname_np(pthread_self(), name);  // Linux 限制 15 字节
+#endif
+    }
+
+    // 后台写入线程函数：批量取出、合并写入，按字节数/时间阈值 flush
     void backgroundWrite() {
+        setCurrentThreadName("zr-logger");
+        std::string line;
+        std::string batch;
+        std::string console;
+        std::string text;
+        std::vector<bool> formats_written(BinaryLog::MAX_FORMATS, false);
+        batch.reserve(FLUSH_BYTES * 2);
+        size_t unflushed = 0;
+        uint64_t reported_drops = 0;
+        uint64_t reported_truncations = 0;
+        auto last_flush = std::chrono::steady_clock::now();
+
         while (true) {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            // 等待队列非空或收到停止信号
-            cv_.wait(lock, [this] { return !log_queue_.empty() || stop_.load(); });
+            bool urgent = false;
+            size_t taken = 0;
+            uint8_t kind = KIND_TEXT;
+            const auto now = std::chrono::steady_clock::now();
+            while (taken < WRITE_BATCH && ring_.tryPop(kind, line)) {
+                appendRecord(kind, line, batch, console, text, formats_written, now);
+                urgent = urgent || (kind & ~KIND_CONSOLE) == KIND_URGENT;
+                ++taken;
+            }
+
+            const uint64_t drops = dropped_.load(std::memory_order_relaxed);
+            if (drops != reported_drops) {
+                appendRecord(KIND_TEXT, "[Logger] 日志缓冲区已满，累计丢弃 " + std::to_string(drops) + " 条",
+                    batch, console, text, formats_written, now);
+                reported_drops = drops;
+            }
+            const uint64_t truncations = ring_.truncatedCount();
+            if (truncations != reported_truncations) {
+                appendRecord(KIND_TEXT, "[Logger] 消息超过 " + std::to_string(LogRing::MAX_MESSAGE_BYTES) +
+                    " 字节被截断，累计 " + std::to_string(truncations) + " 条",
+                    batch, console, text, formats_written, now);
+                reported_truncations = truncations;
+            }
 
-            // 如果收到停止信号且队列为空，则退出循环
-            if (stop_.load() && log_queue_.empty()) {
-                break;
+            // 所有控制台输出在此合并为一次写入，测量线程不再直接写 std::cout
+            if (!console_sites_.empty()) {
+                flushConsoleSites(now, console, false);
+            }
+            if (!console.empty()) {
+                std::cout << console << std::flush;
+                console.clear();
             }
 
-            // 取出队列头部的日志行
-            std::string logLine = std::move(log_queue_.front());
-            log_queue_.pop();
-            lock.unlock(); // 释放锁，以便其他线程可以继续入队
+            if (!batch.empty() && isInitialized_ && file_.is_open()) {
+                file_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                unflushed += batch.size();
+            }
+            batch.clear();
 
-            // 写入文件
-            if (isInitialized_ && file_.is_open()) {
-                file_ << logLine << '\n';
-                file_.flush(); // 确保立即写入磁盘
+            if (unflushed > 0 && (urgent || unflushed >= FLUSH_BYTES || now - last_flush >= FLUSH_INTERVAL)) {
+                file_.flush();
+                unflushed = 0;
+                last_flush = now;
+            }
+
+            if (taken == 0) {
+                // 收到停止信号且缓冲区已取空，则退出循环
+                if (stop_.load(std::memory_order_acquire)) {
+                    break;
+                }
+                std::this_thread::sleep_for(IDLE_SLEEP);
             }
         }
 
+        // 补打尚未输出的合并行
+        flushConsoleSites(std::chrono::steady_clock::now(), console, true);
+        if (!console.empty()) {
+            std::cout << console << std::flush;
+        }
+
         // 线程退出前，写入结束标记并关闭文件
         if (isInitialized_ && file_.is_open()) {
-            file_ << "[" << getCurrentTimeStr() << "] === ZRDDS-Perf-Bench Log Finished ===\n";
+            appendRecord(KIND_TEXT, "[" + getCurrentTimeStr() + "] === ZRDDS-Perf-Bench Log Finished ===",
+                batch, console, text, formats_written, std::chrono::steady_clock::now());
+            file_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
             file_.flush();
             file_.close();
             isInitialized_ = false;
         }
     }
 
-    // 将日志行加入队列
-    void pushLog(const std::string& logLine) {
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            if (stop_.load()) return; // 如果已停止，则不入队
-            log_queue_.push(logLine);
+    // 将日志行写入环形缓冲区；满时按溢出策略丢弃或等待
+    void pushLog(const std::string& logLine, uint8_t kind = KIND_TEXT) {
+        pushLog(logLine.data(), logLine.size(), kind);
+    }
+
+    void pushLog(const char* data, size_t len, uint8_t kind) {
+        if (stop_.load(std::memory_order_relaxed)) return; // 如果已停止，则不入队
+        // 二进制记录截断后无法解码，不追加文本标记（只计数）
+        const bool text = (kind & ~KIND_CONSOLE) != KIND_BINARY;
+        while (!ring_.tryPush(kind, data, len, text)) {
+            if (overflow_policy_.load(std::memory_order_relaxed) == static_cast<int>(Logger::OverflowPolicy::Drop) ||
+                stop_.load(std::memory_order_relaxed)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // 文件行 + 控制台文本：控制台部分为 line 中从 consoleOffset 开始的后缀，site 为调用位置键（0 表示未知）。
+    // 已停止时退回到调用线程同步打印，保证关闭后的输出不丢失
+    void pushPrint(const std::string& line, size_t consoleOffset, bool urgent, uint64_t site) {
+        if (stop_.load(std::memory_order_relaxed)) {
+            std::cout << line.substr(consoleOffset) << std::endl;
+            return;
         }
-        cv_.notify_one(); // 通知后台线程有新日志
+        std::string record;
+        record.reserve(sizeof(uint16_t) + sizeof(uint64_t) + line.size());
+        const uint16_t offset = static_cast<uint16_t>(consoleOffset <= 0xFFFF ? consoleOffset : 0);
+        record.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        record.append(reinterpret_cast<const char*>(&site), sizeof(site));
+        record.append(line);
+        pushLog(record, static_cast<uint8_t>((urgent ? KIND_URGENT : KIND_TEXT) | KIND_CONSOLE));
     }
 
     // 初始化日志系统
@@ -174,7 +440,7 @@ public:
 
         log_directory_ = logDirectory;
         log_file_prefix_ = filePrefix;
-        log_file_suffix_ = fileSuffix;
+        log_file_suffix_ = binary_output_ ? std::string(".bin") : fileSuffix;
 
         // 创建日志目录（如果不存在）
         if (!std::filesystem::exists(log_directory_)) {
@@ -188,19 +454,31 @@ public:
 
         // 生成并打开日志文件
         std::string logFileName = generateLogFileName();
-        file_.open(logFileName, std::ios::out | std::ios::app); // 追加模式
+        auto mode = std::ios::out | std::ios::app; // 追加模式
+        if (binary_output_) {
+            mode |= std::ios::binary;
+        }
+        file_.open(logFileName, mode);
         if (!file_.is_open()) {
             std::cerr << "[Error] 无法打开日志文件: " << logFileName << std::endl;
             return false;
         }
 
-        // 写入日志开始标记
+        // 二进制日志以文件头和时钟锚点开头；锚点在后台线程启动写入前确定
+        anchor_ = BinaryLog::ClockAnchor::now();
+        if (binary_output_) {
+            std::string fileHeader;
+            BinaryLog::appendFileHeader(fileHeader, anchor_);
+            file_.write(fileHeader.data(), static_cast<std::streamsize>(fileHeader.size()));
+        }
+
+        // 写入日志开始标记（文件已打开，先置初始化标志，后台线程才会写出）
+        isInitialized_ = true;
         std::string header = "[" + getCurrentTimeStr() + "] === ZRDDS-Perf-Bench Log Started ===\n"
             "Log File: " + logFileName + "\n"
             "----------------------------------------";
         pushLog(header);
 
-        isInitialized_ = true;
         std::cout << "[Logger] 日志系统已启动\n";
 
         return true;
@@ -208,8 +486,7 @@ public:
 
     // 关闭日志系统
     void close() {
-        if (stop_.exchange(true)) return; // 原子地设置停止标志，如果已停止则直接返回
-        cv_.notify_all(); // 唤醒所有等待的线程（主要是后台写入线程）
+        stop_.store(true, std::memory_order_release); // 后台线程取空缓冲区后自行退出
     }
 
     // 构造函数：启动后台写入线程
@@ -283,7 +560,7 @@ void Logger::error(const std::string& msg) {
         std::cerr << line << " [Warning] (日志未启用)\n";
         return;
     }
-    pImpl_->pushLog(line);
+    pImpl_->pushLog(line, Impl::KIND_URGENT);
 }
 
 // 公共接口：记录配置信息
@@ -310,13 +587,97 @@ void Logger::logResult(const std::string& result) {
     }
 }
 
-// 公共接口：记录并打印
-void Logger::logAndPrint(const std::string& msg) {
-    std::cout << msg << std::endl; // 先打印到控制台
+// 公共接口：记录并打印（控制台输出交给后台线程，调用线程不等待控制台）
+void Logger::logAndPrint(const std::string& msg, const char* callerFile, int callerLine) {
+    std::string line = "[LOG] " + pImpl_->getCurrentTimeStr() + " ";
+    const size_t offset = line.size();
+    line += msg;
+    pImpl_->pushPrint(line, offset, false, Impl::siteKey(callerFile, callerLine));
+}
+
+// 公共接口：报告输出（不限速）
+void Logger::printReport(const std::string& msg) {
+    std::string line = "[LOG] " + pImpl_->getCurrentTimeStr() + " ";
+    const size_t offset = line.size();
+    line += msg;
+    pImpl_->pushPrint(line, offset, false, Impl::CONSOLE_SITE_UNLIMITED);
+}
+
+// 公共接口：溢出策略
+void Logger::setOverflowPolicy(OverflowPolicy policy) {
+    pImpl_->overflow_policy_.store(static_cast<int>(policy), std::memory_order_relaxed);
+}
+
+Logger::OverflowPolicy Logger::overflowPolicy() const {
+    return static_cast<OverflowPolicy>(pImpl_->overflow_policy_.load(std::memory_order_relaxed));
+}
+
+uint64_t Logger::droppedCount() const {
+    return pImpl_->dropped_.load(std::memory_order_relaxed);
+}
+
+uint64_t Logger::truncatedCount() const {
+    return pImpl_->ring_.truncatedCount();
+}
+
+// 公共接口：运行期日志级别
+void Logger::setLevel(int level) {
+    if (level < LOG_LEVEL_TRACE) level = LOG_LEVEL_TRACE;
+    if (level > LOG_LEVEL_OFF) level = LOG_LEVEL_OFF;
+    level_.store(level, std::memory_order_relaxed);
+}
+
+int Logger::parseLevel(const std::string& name, int fallback) {
+    static const char* const names[] = { "trace", "debug", "info", "warn", "error", "off" };
+    for (int i = LOG_LEVEL_TRACE; i <= LOG_LEVEL_OFF; ++i) {
+        if (name == names[i]) return i;
+    }
+    return fallback;
+}
+
+// 公共接口：带级别写入（LOG_xxx 宏的落点）
+void Logger::write(int level, const std::string& msg, bool print, const char* callerFile, int callerLine) {
+    static const char* const tags[] = { "[TRACE] ", "[DEBUG] ", "[INFO] ", "[WARN] ", "[ERROR] " };
+    if (level < LOG_LEVEL_TRACE || level >= LOG_LEVEL_OFF) return;
+
+    if (!pImpl_->isInitialized_ && level >= LOG_LEVEL_ERROR) {
+        std::cerr << tags[level] << msg << " [Warning] (日志未启用)\n";
+        return;
+    }
+    const bool urgent = level >= LOG_LEVEL_ERROR;
+    std::string line = tags[level] + pImpl_->getCurrentTimeStr() + " ";
+    const size_t offset = line.size();
+    line += msg;
+    if (print) {
+        pImpl_->pushPrint(line, offset, urgent, Impl::siteKey(callerFile, callerLine));
+    }
+    else if (pImpl_->isInitialized_) {
+        pImpl_->pushLog(line, urgent ? Impl::KIND_URGENT : Impl::KIND_TEXT);
+    }
+}
+
+// 公共接口：控制台限速
+void Logger::setConsoleRateLimit(uint32_t linesPerSecond) {
+    pImpl_->console_rate_.store(linesPerSecond, std::memory_order_relaxed);
+}
+
+// 公共接口：二进制日志
+void Logger::setBinaryOutput(bool enabled) {
     if (pImpl_->isInitialized_) {
-        std::string line = "[LOG] " + pImpl_->getCurrentTimeStr() + " " + msg;
-        pImpl_->pushLog(line); // 再加入日志队列
+        std::cerr << "[WARNING] 日志已初始化，二进制输出设置需在 setupLogger 之前调用\n";
+        return;
     }
+    pImpl_->binary_output_.store(enabled, std::memory_order_relaxed);
+}
+
+bool Logger::binaryOutput() const {
+    return pImpl_->binary_output_.load(std::memory_order_relaxed);
+}
+
+// LOG_BIN 入口：日志未初始化时只保留控制台输出（与 log()/logAndPrint() 一致）
+void Logger::pushBinary(const char* data, size_t len, bool print) {
+    if (!pImpl_->isInitialized_ && !print) return;
+    pImpl_->pushLog(data, len, print ? Impl::KIND_BINARY_PRINT : Impl::KIND_BINARY);
 }
 
 // 公共接口：关闭日志
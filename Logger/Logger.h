@@ -1,9 +1,41 @@
 // Logger.h
 #pragma once
+#include "BinaryLog.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <thread>
 
+// ־ֵԽԽҪ
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF   5
+
+// ͼ𣺵ڸü LOG_xxx ڱڱʽֵ
+// ڹԤиǣ LOG_COMPILE_LEVEL=3 ֻ WARN/ERROR
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// logAndPrint ĵλãĬʵڵôֵΪ̨ٵļ
+// ֧ʱΪգ˻ذֺı鲢
+#if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+#define LOG_CALLER_FILE __builtin_FILE()
+#define LOG_CALLER_LINE __builtin_LINE()
+#else
+#define LOG_CALLER_FILE nullptr
+#define LOG_CALLER_LINE 0
+#endif
+
 // ־¼ (ģʽ)
 class Logger {
 public:
@@ -37,8 +69,12 @@ public:
     void logConfig(const std::string& configInfo);
     // ¼Ϣ
     void logResult(const std::string& result);
-    // ¼־Ϣͬʱӡ̨
-    void logAndPrint(const std::string& message);
+    // ¼־Ϣͬʱӡ̨̨ɺ̨̺߳ϲд̣߳
+    // callerFile/callerLine ĬʵԶ룬÷贫
+    void logAndPrint(const std::string& message,
+        const char* callerFile = LOG_CALLER_FILE, int callerLine = LOG_CALLER_LINE);
+    //  / ͬ logAndPrint̨٣ֱвᱻϲ
+    void printReport(const std::string& message);
     // ¼ Info Ϣ
     void info(const std::string& msg);
     // ¼ Error Ϣ
@@ -46,6 +82,45 @@ public:
     // ر־ϵͳ
     void close();
 
+    // ־ʱĴʽBlock ȴ̨߳ڳռ䣬Drop 
+    enum class OverflowPolicy { Block, Drop };
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy overflowPolicy() const;
+    uint64_t droppedCount() const;
+    // ޣLogRing::MAX_MESSAGE_BYTESضϵϢ
+    uint64_t truncatedCount() const;
+
+    // ̨٣ͬһλãlogAndPrint / LOG_xxx ļкţͬһ LOG_BIN_PRINTÿӡ
+    // ڴڽʱֻһעϲ0 ʾ
+    void setConsoleRateLimit(uint32_t linesPerSecond);
+
+    // ־Ĭ INFOֻӰ LOG_xxx ꣻlog()/logAndPrint() ȾɽӿڲӰ
+    void setLevel(int level);
+    int level() const { return level_.load(std::memory_order_relaxed); }
+    bool enabled(int level) const { return level >= level_.load(std::memory_order_relaxed); }
+    // "trace"/"debug"/"info"/"warn"/"error"/"off" -> LOG_LEVEL_xxx޷ʶʱ fallback
+    static int parseLevel(const std::string& name, int fallback = LOG_LEVEL_INFO);
+    // ǩдһ־print Ϊ true ʱͬʱӡ̨ͨ LOG_xxx ãλã
+    void write(int level, const std::string& message, bool print,
+        const char* callerFile = nullptr, int callerLine = 0);
+
+    // ־true ʱ־ļΪ .bin LogDecoder ߻ԭ setupLogger ֮ǰ
+    void setBinaryOutput(bool enabled);
+    bool binaryOutput() const;
+
+    // ӳٸʽ·־ֻʽ idʱͲʽں̨߳ɣ LOG_BIN
+    template<typename... Args>
+    void logBinary(uint32_t formatId, bool print, const Args&... args) {
+        if (formatId == 0) return;
+        char buffer[BinaryLog::MAX_RECORD_BYTES];
+        BinaryLog::Encoder encoder(buffer, sizeof(buffer));
+        encoder.begin(formatId,
+            static_cast<int64_t>(std::chrono::steady_clock::now().time_since_epoch().count()),
+            static_cast<uint8_t>(sizeof...(Args)));
+        (encoder.put(args), ...);
+        pushBinary(buffer, encoder.size(), print);
+    }
+
 private:
     // ˽й캯ֹⲿʵ
     Logger();
@@ -55,4 +130,37 @@ private:
     // ʵϸ Impl 
     class Impl;
     std::unique_ptr<Impl> pImpl_;
-};
\ No newline at end of file
+    std::atomic<int> level_{ LOG_LEVEL_INFO };
+
+    void pushBinary(const char* data, size_t len, bool print);
+};
+
+// ּ־꣺ڲüټڼ𣬶߶ͨŹϢַ
+// TRACE/DEBUG ֻд־ļINFO/WARN/ERROR ͬʱӡ̨ERROR 
+#define LOG_AT(level, print, ...)                                                     \
+    do {                                                                              \
+        if constexpr ((level) >= LOG_COMPILE_LEVEL) {                                 \
+            if (Logger::getInstance().enabled(level)) {                               \
+                Logger::getInstance().write(level, (__VA_ARGS__), print, __FILE__, __LINE__); \
+            }                                                                         \
+        }                                                                             \
+    } while (0)
+
+#define LOG_TRACE(...) LOG_AT(LOG_LEVEL_TRACE, false, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, false, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LOG_LEVEL_INFO, true, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LOG_LEVEL_WARN, true, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, true, __VA_ARGS__)
+
+// ӳٸʽ־꣺ʽʹ "{}" ռλ LOG_BIN("ѷ {} ", count)
+// ʽ״ִʱעᣬ֮ÿεֻ
+#define LOG_BIN_IMPL(print, fmt, ...)                                                   \
+    do {                                                                              \
+        static const uint32_t zr_log_bin_id_ = BinaryLog::registerFormat(fmt, __FILE__, __LINE__); \
+        Logger::getInstance().logBinary(zr_log_bin_id_, print, ##__VA_ARGS__);          \
+    } while (0)
+
+// ֻд־ļ
+#define LOG_BIN(fmt, ...) LOG_BIN_IMPL(false, fmt, ##__VA_ARGS__)
+// д־ļɺ̸̨߳ʽӡ̨
+#define LOG_BIN_PRINT(fmt, ...) LOG_BIN_IMPL(true, fmt, ##__VA_ARGS__)
\ No newline at end of file
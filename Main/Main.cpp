@@ -17,9 +17,14 @@
 #include "Config.h"
 #include "Logger.h"
 #include "GloMemPool.h"
+#include "RoundArena.h"
 #include "Throughput_Bytes.h"
 #include "Throughput_ZeroCopyBytes.h"  
+#include "Latency_Bytes.h"
+#include "Latency_ZeroCopyBytes.h"
 #include "MetricsReport.h"
+#include "ResultWriter.h"
+#include "ResultCompare.h"
 #include "TestRoundResult.h"
 #include "ResourceUtilization.h"
 
@@ -31,9 +36,60 @@ namespace {
     std::string logSuffix = GlobalConfig::LOG_FILE_SUFFIX;
     std::string resultDir = GlobalConfig::DEFAULT_RESULT_PATH;
     bool loggingEnabled = true;
+
+    // compare 模式的退出码：0 = 无回退，1 = 存在回退，2 = 参数或文件错误
+    constexpr int COMPARE_EXIT_REGRESSION = 1;
+    constexpr int COMPARE_EXIT_ERROR = 2;
+
+    // 用法：<程序> compare <基线结果文件> <候选结果文件> [--threshold 百分比] [--alpha 显著性水平]
+    int runCompare(int argc, char* argv[]) {
+        if (argc < 4) {
+            std::cerr << "用法: " << argv[0]
+                << " compare <基线结果文件> <候选结果文件> [--threshold 百分比] [--alpha 显著性水平]" << std::endl;
+            return COMPARE_EXIT_ERROR;
+        }
+
+        ResultCompare::Options options;
+        for (int i = 4; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if ((arg == "--threshold" || arg == "--alpha") && i + 1 < argc) {
+                char* end = nullptr;
+                const double value = std::strtod(argv[++i], &end);
+                if (end == argv[i] || value < 0.0) {
+                    std::cerr << "[Error] 无效的参数值: " << arg << " " << argv[i] << std::endl;
+                    return COMPARE_EXIT_ERROR;
+                }
+                (arg == "--threshold" ? options.threshold_percent : options.alpha) = value;
+            }
+            else {
+                std::cerr << "[Error] 未知参数: " << arg << std::endl;
+                return COMPARE_EXIT_ERROR;
+            }
+        }
+
+        std::vector<ResultCompare::Row> baseline, candidate;
+        std::string error;
+        if (!ResultCompare::loadFile(argv[2], baseline, error) || !ResultCompare::loadFile(argv[3], candidate, error)) {
+            std::cerr << "[Error] " << error << std::endl;
+            return COMPARE_EXIT_ERROR;
+        }
+
+        const ResultCompare::Report report = ResultCompare::compare(baseline, candidate, options);
+        ResultCompare::print(report, options, std::cout);
+        if (report.comparisons.empty()) {
+            std::cerr << "[Error] 两个结果文件没有可匹配的轮次" << std::endl;
+            return COMPARE_EXIT_ERROR;
+        }
+        return report.regressions > 0 ? COMPARE_EXIT_REGRESSION : EXIT_SUCCESS;
+    }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // 对比模式不启动 DDS，也不等待按键，便于在流水线中作为性能门禁
+    if (argc >= 2 && std::string(argv[1]) == "compare") {
+        return runCompare(argc, argv);
+    }
+
     try {
         // ================= 初始化全局内存池 =================
         if (!GloMemPool::initialize()) {
@@ -44,6 +100,7 @@ int main() {
         Logger::getInstance().logAndPrint("[Memory] 使用 GloMemPool 管理全局内存");
 
         // ================= 初始化日志系统 =================
+        Logger::getInstance().setBinaryOutput(GlobalConfig::LOG_BINARY_OUTPUT);
         Logger::setupLogger(logDir, logPrefix, logSuffix);
 
         // ================= 加载并选择配置 =================
@@ -55,6 +112,11 @@ int main() {
         }
 
         const ConfigData& base_config = config.getCurrentConfig();
+        if (base_config.m_logOverflow == "drop") {
+            Logger::getInstance().setOverflowPolicy(Logger::OverflowPolicy::Drop);
+        }
+        Logger::getInstance().setLevel(Logger::parseLevel(base_config.m_logLevel));
+        ResourceUtilization::instance().setNetworkInterface(base_config.m_netInterface);
         const int total_rounds = base_config.m_loopNum;
 
         Logger::getInstance().logAndPrint("\n=== 当前选中的配置模板 ===");
@@ -72,6 +134,8 @@ int main() {
 
         // ==================== 根据配置决定传输模式 ====================
         bool is_zero_copy_mode = (base_config.m_typeName == "DDS::ZeroCopyBytes");
+        // delay:: 前缀的配置走 ping-pong 时延测试，其余走吞吐测试
+        bool is_latency_mode = (base_config.name.rfind("delay::", 0) == 0 && base_config.m_latencyMode == "pp");
 
         std::unique_ptr<DDSManager_Bytes> bytes_manager;
         std::unique_ptr<DDSManager_ZeroCopyBytes> zc_manager;
@@ -79,8 +143,15 @@ int main() {
         std::unique_ptr<Throughput_Bytes> throughput_bytes;
         std::unique_ptr<Throughput_ZeroCopyBytes> throughput_zc;
 
+        std::unique_ptr<Latency_Bytes> latency_bytes;
+        std::unique_ptr<Latency_ZeroCopyBytes> latency_zc;
+
         MetricsReport metricsReport;
 
+        // 结果文件：回调中只格式化到内存，每轮清理之后再写盘
+        ResultWriter resultWriter((std::filesystem::path(resultDir) / base_config.m_resultPath).string(), base_config);
+        Logger::getInstance().logAndPrint("[Result] 结果文件: " + resultWriter.path());
+
         // ========== 主循环：多轮测试 ==========
         int total_result = EXIT_SUCCESS;
 
@@ -94,6 +165,9 @@ int main() {
             ConfigData current_cfg = base_config;
             current_cfg.m_activeLoop = round;
 
+            // 本轮临时对象从轮次 arena 分配，按本轮数据大小比较各轮高水位
+            RoundArena::instance().beginRound(round + 1, static_cast<size_t>(current_cfg.m_minSize[round]));
+
             // 打印本轮参数
             std::ostringstream roundCfgStream;
             Config::printConfigToStream(current_cfg, roundCfgStream);
@@ -107,22 +181,46 @@ int main() {
 
                     zc_manager = std::make_unique<DDSManager_ZeroCopyBytes>(current_cfg, qos_file_path);
 
-                    throughput_zc = std::make_unique<Throughput_ZeroCopyBytes>(*zc_manager,
-                        [&metricsReport](const TestRoundResult& result) {
-                            metricsReport.addResult(result);
-                        }
-                    );
+                    if (is_latency_mode) {
+                        zc_manager->setEchoMode(true);
+                        latency_zc = std::make_unique<Latency_ZeroCopyBytes>(*zc_manager,
+                            [&metricsReport, &resultWriter](const TestRoundResult& result) {
+                                metricsReport.addResult(result);
+                                resultWriter.addRound(result);
+                            }
+                        );
+                    }
+                    else {
+                        throughput_zc = std::make_unique<Throughput_ZeroCopyBytes>(*zc_manager,
+                            [&metricsReport, &resultWriter](const TestRoundResult& result) {
+                                metricsReport.addResult(result);
+                                resultWriter.addRound(result);
+                            }
+                        );
+                    }
                 }
                 else {
                     Logger::getInstance().logAndPrint("启动 Bytes 模式");
 
                     bytes_manager = std::make_unique<DDSManager_Bytes>(current_cfg, qos_file_path);
 
-                    throughput_bytes = std::make_unique<Throughput_Bytes>(*bytes_manager,
-                        [&metricsReport](const TestRoundResult& result) {
-                            metricsReport.addResult(result);
-                        }
-                    );
+                    if (is_latency_mode) {
+                        bytes_manager->setEchoMode(true);
+                        latency_bytes = std::make_unique<Latency_Bytes>(*bytes_manager,
+                            [&metricsReport, &resultWriter](const TestRoundResult& result) {
+                                metricsReport.addResult(result);
+                                resultWriter.addRound(result);
+                            }
+                        );
+                    }
+                    else {
+                        throughput_bytes = std::make_unique<Throughput_Bytes>(*bytes_manager,
+                            [&metricsReport, &resultWriter](const TestRoundResult& result) {
+                                metricsReport.addResult(result);
+                                resultWriter.addRound(result);
+                            }
+                        );
+                    }
                 }
 
                 // ==================== 在创建 DDSManager 之后，第一轮测试开始前初始化 ResourceUtilization ====================
@@ -140,10 +238,59 @@ int main() {
             }
 
             // ------------------- 重新初始化 DDSManager -------------------
+            // 接收端先重置本轮状态：initialize 创建 reader 后 Listener 即可能回调
+            if (!is_latency_mode && !current_cfg.m_isPositive) {
+                if (is_zero_copy_mode) {
+                    throughput_zc->prepareRound(current_cfg);
+                }
+                else {
+                    throughput_bytes->prepareRound(current_cfg);
+                }
+            }
+
             bool init_success = false;
 
             // 每轮都重新定义回调，避免 move 后失效
-            if (is_zero_copy_mode) {
+            if (is_latency_mode) {
+                // 时延模式：发送端接收回显，接收端回显收到的样本
+                if (is_zero_copy_mode) {
+                    if (current_cfg.m_isPositive) {
+                        init_success = zc_manager->initialize(
+                            [&](const DDS::ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
+                                latency_zc->onEchoReceived(sample, info);
+                            }
+                        );
+                    }
+                    else {
+                        auto end_callback = [&]() { latency_zc->onEndOfRound(); };
+                        init_success = zc_manager->initialize(
+                            [&](const DDS::ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
+                                latency_zc->onDataReceived(sample, info);
+                            },
+                            end_callback
+                        );
+                    }
+                }
+                else {
+                    if (current_cfg.m_isPositive) {
+                        init_success = bytes_manager->initialize(
+                            [&](const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+                                latency_bytes->onEchoReceived(sample, info);
+                            }
+                        );
+                    }
+                    else {
+                        auto end_callback = [&]() { latency_bytes->onEndOfRound(); };
+                        init_success = bytes_manager->initialize(
+                            [&](const DDS::Bytes& sample, const DDS::SampleInfo& info) {
+                                latency_bytes->onDataReceived(sample, info);
+                            },
+                            end_callback
+                        );
+                    }
+                }
+            }
+            else if (is_zero_copy_mode) {
                 if (current_cfg.m_isPositive) {
                     init_success = zc_manager->initialize();
                 }
@@ -179,7 +326,8 @@ int main() {
             }
 
             // ------------------- Publisher: 等待 Subscriber 重连（从第二轮开始）-------------------
-            if (current_cfg.m_isPositive && round > 0) {
+            // 时延模式下 runPublisher 自己等待双向匹配
+            if (current_cfg.m_isPositive && round > 0 && !is_latency_mode) {
                 Logger::getInstance().logAndPrint("等待订阅者重新上线以启动第 " + std::to_string(round + 1) + " 轮...");
 
                 bool connected = false;
@@ -197,7 +345,19 @@ int main() {
 
             // ------------------- 运行单轮测试 -------------------
             int result = 0;
-            if (current_cfg.m_isPositive) {
+            if (is_latency_mode) {
+                if (current_cfg.m_isPositive) {
+                    result = is_zero_copy_mode
+                        ? latency_zc->runPublisher(current_cfg)
+                        : latency_bytes->runPublisher(current_cfg);
+                }
+                else {
+                    result = is_zero_copy_mode
+                        ? latency_zc->runSubscriber(current_cfg)
+                        : latency_bytes->runSubscriber(current_cfg);
+                }
+            }
+            else if (current_cfg.m_isPositive) {
                 result = is_zero_copy_mode
                     ? throughput_zc->runPublisher(current_cfg)
                     : throughput_bytes->runPublisher(current_cfg);
@@ -224,6 +384,20 @@ int main() {
                 bytes_manager->shutdown();
             }
 
+            // 本轮对象均已析构，一次性回收轮次 arena
+            const RoundArenaReport arena_report = RoundArena::instance().endRound();
+            if (arena_report.high_water_growth || arena_report.pool_leak) {
+                Logger::getInstance().logAndPrint(
+                    "[Memory][Warning] 第 " + std::to_string(round + 1) + " 轮 arena 高水位=" +
+                    std::to_string(arena_report.high_water) + " B, GloMemPool 块增量=" +
+                    std::to_string(arena_report.pool_block_delta) +
+                    (arena_report.pool_leak ? "，连续多轮增长，疑似泄漏" : "，高水位超过此前各轮最大值")
+                );
+            }
+
+            // 测量窗口之外写入本轮结果
+            resultWriter.flush();
+
             // 防止端口冲突或资源竞争
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
@@ -231,9 +405,30 @@ int main() {
         // ==================== 测试结束，生成报告 ====================
         Logger::getInstance().logAndPrint("\n--- 开始生成系统资源使用报告 ---");
         metricsReport.generateSummary();
+        resultWriter.flush();
 
         // 关闭资源采集
         ResourceUtilization::instance().shutdown();
+
+        // 尺寸类分配器统计
+        for (const auto& cls : GloMemPool::getSlabStats()) {
+            if (cls.alloc_count == 0) continue;
+            Logger::getInstance().logAndPrint(
+                "[Memory] slab " + std::to_string(cls.block_size) + "B: 大块=" + std::to_string(cls.chunks) +
+                ", 切分=" + std::to_string(cls.blocks_carved) + ", 峰值占用=" + std::to_string(cls.peak_in_use) +
+                ", 分配=" + std::to_string(cls.alloc_count) + ", 释放=" + std::to_string(cls.free_count)
+            );
+        }
+        Logger::getInstance().logAndPrint("[Memory] 直接 ZRMalloc 分配: " + std::to_string(GloMemPool::getDirectAllocCount()));
+        const GloMemPool::Stats mem_stats = GloMemPool::getStats();
+        Logger::getInstance().logAndPrint(
+            "[Memory] magazine 命中=" + std::to_string(mem_stats.cache_hits) +
+            ", 未命中=" + std::to_string(mem_stats.cache_misses) +
+            ", 批量归还=" + std::to_string(mem_stats.cache_flushes) +
+            ", 命中率=" + std::to_string(mem_stats.cache_hit_rate * 100.0) + "%"
+        );
+
+        RoundArena::instance().release();
         GloMemPool::finalize();
 
         // --- 新增：程序结束前暂停，防止 cmd 窗口关闭 ---
@@ -53,6 +53,12 @@ namespace GlobalConfig {
      */
     constexpr const char* LOG_FILE_SUFFIX = ".log";
 
+    /**
+     * @brief ǷԶƸʽд־.bin
+     *  LOG_BIN ¼ʱʽ LogDecoder ԭΪı
+     */
+    constexpr bool LOG_BINARY_OUTPUT = false;
+
     /*
 	 * @brief ĬϵĽĿ¼
      * ᳢ڴĿ¼´ļ
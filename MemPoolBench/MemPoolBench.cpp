@@ -0,0 +1,102 @@
+﻿// MemPoolBench.cpp
+// GloMemPool 尺寸类分配器（含/不含线程本地 magazine）与裸 ZRMalloc 的对比微基准
+#include "GloMemPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr int ITERATIONS = 200000;  // 每种尺寸的分配/释放次数
+constexpr int BATCH = 256;          // 批量模式下同时持有的块数
+
+// 接近吞吐测试 m_minSize 的常见取值（含非 2 的幂）
+const size_t kSizes[] = { 64, 100, 256, 1000, 1024, 4096, 8192, 16384, 65536, 262144, 1048576 };
+
+struct Result {
+    double single_ns;  // 分配后立即释放，单次 ns
+    double batch_ns;   // 批量分配 BATCH 个再全部释放，单次 ns
+};
+
+template <typename AllocFn, typename FreeFn>
+Result runCase(size_t size, AllocFn alloc, FreeFn release) {
+    using Clock = std::chrono::steady_clock;
+    Result r{};
+
+    // 预热：让 slab 切出足够的块，避免首次申请大块计入测量
+    std::vector<void*> held(BATCH, nullptr);
+    for (int i = 0; i < BATCH; ++i) held[i] = alloc(size);
+    for (int i = 0; i < BATCH; ++i) release(held[i]);
+
+    auto t0 = Clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        void* p = alloc(size);
+        // 触碰首字节，防止编译器消除分配
+        static_cast<volatile char*>(p)[0] = static_cast<char>(i);
+        release(p);
+    }
+    auto t1 = Clock::now();
+    r.single_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / ITERATIONS;
+
+    const int rounds = ITERATIONS / BATCH;
+    t0 = Clock::now();
+    for (int k = 0; k < rounds; ++k) {
+        for (int i = 0; i < BATCH; ++i) {
+            held[i] = alloc(size);
+            static_cast<volatile char*>(held[i])[0] = static_cast<char>(i);
+        }
+        for (int i = BATCH - 1; i >= 0; --i) release(held[i]);
+    }
+    t1 = Clock::now();
+    r.batch_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / (static_cast<double>(rounds) * BATCH);
+    return r;
+}
+
+} // namespace
+
+int main() {
+    GloMemPool::initialize();
+
+    std::printf("%-10s %12s %12s %12s %12s %12s %12s %9s\n",
+        "size", "raw", "slab", "slab+mag", "raw批量", "slab批量", "mag批量", "加速比");
+
+    auto pooled = [](size_t size) {
+        return runCase(size,
+            [](size_t n) { return GloMemPool::allocate(n); },
+            [](void* p) { GloMemPool::deallocate(p); });
+    };
+
+    GloMemPool::setSlabEnabled(true);
+    for (size_t size : kSizes) {
+        const Result raw = runCase(size,
+            [](size_t n) { return ZRMalloc(nullptr, static_cast<DDS_ULong>(n)); },
+            [](void* p) { ZRDealloc(nullptr, p); });
+
+        GloMemPool::setMagazineEnabled(false);
+        const Result slab = pooled(size);
+        GloMemPool::setMagazineEnabled(true);
+        const Result mag = pooled(size);
+
+        const double speedup = mag.batch_ns > 0.0 ? raw.batch_ns / mag.batch_ns : 0.0;
+        std::printf("%-10zu %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f %8.2fx\n",
+            size, raw.single_ns, slab.single_ns, mag.single_ns, raw.batch_ns, slab.batch_ns, mag.batch_ns, speedup);
+    }
+
+    std::printf("\n%-10s %8s %10s %10s %12s %12s\n", "class", "chunks", "carved", "peak", "alloc", "free");
+    const auto stats = GloMemPool::getSlabStats();
+    for (const auto& c : stats) {
+        if (c.alloc_count == 0) continue;
+        std::printf("%-10zu %8zu %10zu %10zu %12zu %12zu\n",
+            c.block_size, c.chunks, c.blocks_carved, c.peak_in_use, c.alloc_count, c.free_count);
+    }
+    std::printf("direct (ZRMalloc) allocations: %zu\n", GloMemPool::getDirectAllocCount());
+
+    const GloMemPool::Stats st = GloMemPool::getStats();
+    std::printf("magazine: hits=%zu misses=%zu flushes=%zu hit_rate=%.2f%%\n",
+        st.cache_hits, st.cache_misses, st.cache_flushes, st.cache_hit_rate * 100.0);
+
+    GloMemPool::finalize();
+    return 0;
+}
@@ -1,6 +1,10 @@
 ﻿// MetricsReport.cpp
 #include "MetricsReport.h"
 #include "Logger.h"
+#include "RoundArena.h"
+#include "ResourceUtilization.h"
+#include "NetMetrics.h"
+#include <cmath>
 #include <numeric>
 #include <sstream>
 #include <iomanip>
@@ -11,6 +15,7 @@ void MetricsReport::addResult(const TestRoundResult& result) {
     std::lock_guard<std::mutex> lock(mtx_);
 
     TestRoundResult processed_result = result; // Copy for processing
+    processed_result.cpu_stats = computeCpuStats(result.cpu_usage_history);
 
     // --- 精细化：从历史记录中计算最终的、一致的 CPU 峰值 ---
     if (!result.cpu_usage_history.empty()) {
@@ -29,14 +34,14 @@ void MetricsReport::addResult(const TestRoundResult& result) {
                 if (final_peak >= 0.0f) {
                     // 将计算出的最终峰值存入 processed_result 的 end_metrics 中
                     processed_result.end_metrics.cpu_usage_percent_peak = static_cast<double>(final_peak);
-                    Logger::getInstance().logAndPrint(
+                    Logger::getInstance().printReport(
                         "[MetricsReport::addResult] [PEAK CALCULATED] Round " + std::to_string(result.round_index) +
                         " | Final Peak CPU: " + std::to_string(final_peak) + "% (from history max)"
                     );
                 }
                 else {
                     // 理论上 GetProcessTimes 不应产生负值，但以防万一
-                    Logger::getInstance().logAndPrint(
+                    Logger::getInstance().printReport(
                         "[MetricsReport::addResult] [WARNING] Round " + std::to_string(result.round_index) +
                         " | Calculated final CPU peak is negative (" + std::to_string(final_peak) + "%). Clamping to 0.0%."
                     );
@@ -45,7 +50,7 @@ void MetricsReport::addResult(const TestRoundResult& result) {
             }
             else {
                 // 处理 NaN 或 Inf 的情况
-                Logger::getInstance().logAndPrint(
+                Logger::getInstance().printReport(
                     "[MetricsReport::addResult] [ERROR] Round " + std::to_string(result.round_index) +
                     " | Calculated final CPU peak is not finite (NaN/Inf: " + std::to_string(final_peak) + "). Setting to -1.0 (Error)."
                 );
@@ -54,7 +59,7 @@ void MetricsReport::addResult(const TestRoundResult& result) {
         }
         else {
             // 理论上不会发生 (vector 不空且 max_element 应该能找到元素)
-            Logger::getInstance().logAndPrint(
+            Logger::getInstance().printReport(
                 "[MetricsReport::addResult] [ERROR] Round " + std::to_string(result.round_index) +
                 " | cpu_usage_history was not empty but std::max_element failed unexpectedly."
             );
@@ -62,7 +67,7 @@ void MetricsReport::addResult(const TestRoundResult& result) {
         }
     }
     else {
-        Logger::getInstance().logAndPrint(
+        Logger::getInstance().printReport(
             "[MetricsReport::addResult] [INFO] Round " + std::to_string(result.round_index) +
             " | No CPU usage history recorded. Attempting to use internal tracker value or setting to -1.0."
         );
@@ -71,7 +76,7 @@ void MetricsReport::addResult(const TestRoundResult& result) {
         // 如果内部峰值也是 -1.0 或无效，则最终结果保持 -1.0 (无数据)
         double internal_peak = result.end_metrics.cpu_usage_percent_peak;
         if (std::isfinite(internal_peak) && internal_peak >= 0.0) {
-            Logger::getInstance().logAndPrint(
+            Logger::getInstance().printReport(
                 "[MetricsReport::addResult] [PEAK FALLBACK] Round " + std::to_string(result.round_index) +
                 " | Using internal tracker peak: " + std::to_string(internal_peak) + "%"
             );
@@ -81,7 +86,7 @@ void MetricsReport::addResult(const TestRoundResult& result) {
         }
         else {
             // 内部队列峰值也无效或无数据，保持为 -1.0
-            Logger::getInstance().logAndPrint(
+            Logger::getInstance().printReport(
                 "[MetricsReport::addResult] [INFO] Round " + std::to_string(result.round_index) +
                 " | Internal tracker peak is also invalid (" + std::to_string(internal_peak) + ") or not set. Final peak remains -1.0 (No Data/Error)."
             );
@@ -103,6 +108,10 @@ void MetricsReport::addResult(const TestRoundResult& result) {
     // 格式化输出，区分有效值、无数据和错误
     if (end_metrics.cpu_usage_percent_peak >= 0.0) {
         cpu_oss << "CPU峰值: " << end_metrics.cpu_usage_percent_peak << "%";
+        const CpuUsageStats& cpu = processed_result.cpu_stats;
+        if (cpu.samples > 0) {
+            cpu_oss << " | 平均: " << cpu.avg << "% | p95: " << cpu.p95 << "% | 采样点: " << cpu.samples;
+        }
     }
     else if (end_metrics.cpu_usage_percent_peak == -1.0) {
         cpu_oss << "CPU峰值: 无数据/错误"; // 更明确地表示 -1.0 的含义
@@ -111,7 +120,12 @@ void MetricsReport::addResult(const TestRoundResult& result) {
         // 处理其他可能的错误代码 (如果有的话)
         cpu_oss << "CPU峰值: 错误(" << end_metrics.cpu_usage_percent_peak << ")";
     }
-    Logger::getInstance().logAndPrint(cpu_oss.str());
+    Logger::getInstance().printReport(cpu_oss.str());
+    // processed_result 的 vector 成员已移入 results_，从 results_.back() 读取
+    printThreadUsage(results_.back());
+    printResourceTimeline(results_.back());
+    printNetwork(results_.back());
+    printPerfCounters(results_.back());
     // --- 实时输出结束 ---
 }
 
@@ -119,11 +133,11 @@ void MetricsReport::generateSummary() const {
     std::lock_guard<std::mutex> lock(mtx_);
 
     if (results_.empty()) {
-        Logger::getInstance().logAndPrint("[Metrics] 无资源监控数据可汇总");
+        Logger::getInstance().printReport("[Metrics] 无资源监控数据可汇总");
         return;
     }
 
-    Logger::getInstance().logAndPrint("\n=== 系统资源使用汇总报告 ===");
+    Logger::getInstance().printReport("\n=== 系统资源使用汇总报告 ===");
 
     for (const auto& r : results_) {
         const auto& start = r.start_metrics;
@@ -138,6 +152,9 @@ void MetricsReport::generateSummary() const {
         // 汇总报告中显示最终计算出的峰值
         if (end.cpu_usage_percent_peak >= 0.0) {
             oss << "CPU峰值: " << end.cpu_usage_percent_peak << "% | ";
+            if (r.cpu_stats.samples > 0) {
+                oss << "CPU平均: " << r.cpu_stats.avg << "% | CPU p95: " << r.cpu_stats.p95 << "% | ";
+            }
         }
         else if (end.cpu_usage_percent_peak == -1.0) {
             oss << "CPU峰值: 无数据/错误 | ";
@@ -192,6 +209,283 @@ void MetricsReport::generateSummary() const {
         // --- 修改结束 ---
 
 
-        Logger::getInstance().logAndPrint(oss.str());
+        Logger::getInstance().printReport(oss.str());
+    }
+
+    // ==================== 时延分布汇总（仅时延测试发送端有数据）====================
+    LatencyHistogram overall;
+    for (const auto& r : results_) {
+        if (!r.latency || r.latency->empty()) continue;
+
+        Logger::getInstance().printReport(formatLatencyLine("第 " + std::to_string(r.round_index) + " 轮时延", *r.latency));
+        overall.merge(*r.latency);
+    }
+    if (!overall.empty()) {
+        Logger::getInstance().printReport(formatLatencyLine("全部轮次时延", overall));
+    }
+
+    // ==================== 轮次 arena 高水位与泄漏检查 ====================
+    const std::vector<RoundArenaReport> arena_history = RoundArena::instance().history();
+    bool arena_warning = false;
+    for (const auto& a : arena_history) {
+        std::ostringstream oss;
+        oss << "第 " << a.round << " 轮 arena | key: " << a.key
+            << " | 高水位: " << a.high_water << " B"
+            << " | 分配次数: " << a.allocations
+            << " | 大块: " << a.chunks << " (" << a.reserved / 1024 << " KB)"
+            << " | GloMemPool 块增量: " << a.pool_block_delta;
+        if (a.high_water_growth) oss << " | [警告] 高水位超过此前各轮最大值";
+        if (a.pool_leak) oss << " | [警告] 连续 " << RoundArena::LEAK_ROUNDS << " 轮在用块数增长，疑似泄漏";
+        arena_warning = arena_warning || a.high_water_growth || a.pool_leak;
+        Logger::getInstance().printReport(oss.str());
+    }
+    if (!arena_history.empty() && !arena_warning) {
+        Logger::getInstance().printReport("[Metrics] arena 检查通过：各轮高水位稳定，未发现跨轮累积");
+    }
+}
+
+CpuUsageStats MetricsReport::computeCpuStats(const std::vector<float>& history) {
+    CpuUsageStats stats;
+    std::vector<float> values;
+    values.reserve(history.size());
+    for (float v : history) {
+        if (std::isfinite(v) && v >= 0.0f) values.push_back(v);
+    }
+    if (values.empty()) {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end());
+    stats.samples = values.size();
+    stats.avg = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+    stats.peak = values.back();
+    // 最近秩法：第 ceil(0.95 * n) 个值
+    const size_t rank = static_cast<size_t>(std::ceil(0.95 * static_cast<double>(values.size())));
+    stats.p95 = values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+    return stats;
+}
+
+void MetricsReport::printThreadUsage(const TestRoundResult& result) {
+    const auto& threads = result.cpu_history.threads;
+    if (threads.empty()) {
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "[线程 CPU] 第 " << result.round_index << " 轮 | ";
+    const size_t shown = std::min(threads.size(), MAX_REPORTED_THREADS);
+    for (size_t i = 0; i < shown; ++i) {
+        const ThreadCpuUsage& t = threads[i];
+        if (i > 0) oss << " | ";
+        oss << (t.name.empty() ? "?" : t.name) << "(" << t.tid << ") 平均: " << t.avg_percent
+            << "% 峰值: " << t.peak_percent << "%";
+    }
+    Logger::getInstance().printReport(oss.str());
+
+    // threads 已按最先饱和排序，第一个若饱和即为瓶颈线程
+    std::ostringstream sat;
+    sat << std::fixed << std::setprecision(2) << "[线程 CPU] 第 " << result.round_index << " 轮 | ";
+    const ThreadCpuUsage& first = threads.front();
+    if (first.first_saturated_ms >= 0.0) {
+        sat << "最先饱和: " << (first.name.empty() ? "?" : first.name) << "(" << first.tid << ")，于第 "
+            << first.first_saturated_ms << " ms 达到 " << ResourceUtilization::THREAD_SATURATION_PERCENT << "%";
+    }
+    else {
+        sat << "无线程达到 " << ResourceUtilization::THREAD_SATURATION_PERCENT << "% 饱和";
+    }
+    Logger::getInstance().printReport(sat.str());
+}
+
+void MetricsReport::printResourceTimeline(const TestRoundResult& result) {
+    const ResourceSeries& res = result.samples;
+    const size_t n = res.size();
+    if (n == 0) {
+        return;
+    }
+
+    // 整轮范围：CPU 区间最大值的峰值、工作集与 GloMemPool 的最小/最大值、缺页总增量
+    float cpu_max = -1.0f;
+    uint64_t ws_min = res.working_set_kb[0], ws_max = res.working_set_kb[0];
+    uint64_t pool_min = res.pool_current_kb[0], pool_max = res.pool_current_kb[0];
+    for (size_t j = 0; j < n; ++j) {
+        cpu_max = std::max(cpu_max, res.cpu_percent[j]);
+        ws_min = std::min(ws_min, res.working_set_kb[j]);
+        ws_max = std::max(ws_max, res.working_set_kb[j]);
+        pool_min = std::min(pool_min, res.pool_current_kb[j]);
+        pool_max = std::max(pool_max, res.pool_current_kb[j]);
+    }
+    const uint64_t faults = res.page_faults[n - 1] >= res.page_faults[0] ? res.page_faults[n - 1] - res.page_faults[0] : 0;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "[资源序列] 第 " << result.round_index << " 轮 | " << res.interval_ms << " ms x " << n
+        << " | CPU区间峰值: " << cpu_max << "% | 工作集: " << ws_min << " ~ " << ws_max << " KB"
+        << " | GloMemPool: " << pool_min << " ~ " << pool_max << " KB | 缺页增量: " << faults;
+    if (res.overwritten > 0) {
+        oss << " | 最早 " << res.overwritten << " 个采样点已被覆盖";
+    }
+    Logger::getInstance().printReport(oss.str());
+
+    const auto& series = result.throughput_series;
+    const IntervalStats& stats = result.throughput_stats;
+    if (series.empty() || stats.start_steady_ns == 0) {
+        // 没有吞吐序列（如发送端）：完整资源序列只写日志文件
+        for (size_t j = 0; j < n; ++j) {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(2)
+                << "[Resource] t=" << res.t_ms[j] << "ms cpu=" << res.cpu_percent[j]
+                << "% ws=" << res.working_set_kb[j] << "KB private=" << res.private_kb[j]
+                << "KB pool=" << res.pool_current_kb[j] << "KB faults=" << res.page_faults[j];
+            Logger::getInstance().log(line.str());
+        }
+        return;
+    }
+
+    // 资源采样点 j 的时刻换算到吞吐序列的时间轴（相对第一个包），落入哪个区间就归入哪个区间
+    const double shift_ms = static_cast<double>(res.start_steady_ns - stats.start_steady_ns) / 1e6;
+    // 低谷：完整区间的 pps 低于均值 2 个标准差
+    const double dip_threshold = stats.mean_pps - 2.0 * stats.stddev_pps;
+    size_t j = 0;
+    size_t dips = 0;
+    size_t prev = 0;   // 上一个采样点，累计计数按相邻采样点求差
+    while (j < n && res.t_ms[j] + shift_ms < series.front().offset_ms) {
+        prev = j++;
+    }
+    auto step = [&](const std::vector<uint64_t>& column) -> uint64_t {
+        return column[j] >= column[prev] ? column[j] - column[prev] : 0;
+    };
+    for (size_t i = 0; i < series.size(); ++i) {
+        const IntervalSample& s = series[i];
+        const bool full_interval = i + 1 < series.size();
+        // 最后一个区间截止于最后一个包，停止记录时的采样点稍晚，多留一个采样间隔
+        const double limit_ms = s.offset_ms + s.duration_ms + (full_interval ? 0.0 : res.interval_ms);
+        float interval_cpu = -1.0f;
+        uint64_t interval_ws = 0, interval_pool = 0, interval_faults = 0;
+        uint64_t interval_rx = 0, interval_rcvbuf = 0;
+        size_t matched = 0;
+        while (j < n && res.t_ms[j] + shift_ms < limit_ms) {
+            interval_cpu = std::max(interval_cpu, res.cpu_percent[j]);
+            interval_ws = std::max(interval_ws, res.working_set_kb[j]);
+            interval_pool = std::max(interval_pool, res.pool_current_kb[j]);
+            interval_faults += step(res.page_faults);
+            interval_rx += step(res.net_rx_bytes);
+            interval_rcvbuf += step(res.udp_rcvbuf_errors);
+            prev = j++;
+            ++matched;
+        }
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2)
+            << "t=" << s.offset_ms << "ms pps=" << s.pps << " mbps=" << s.mbps;
+        if (matched > 0) {
+            line << " cpu=" << interval_cpu << "% ws=" << interval_ws << "KB pool=" << interval_pool
+                << "KB faults=" << interval_faults << " net_rx=" << interval_rx << "B rcvbuf_err=" << interval_rcvbuf;
+        }
+        else {
+            line << " (无资源采样点)";
+        }
+        Logger::getInstance().log("[Timeline] " + line.str());
+
+        if (full_interval && stats.stddev_pps > 0.0 && s.pps < dip_threshold && dips++ < MAX_REPORTED_DIPS) {
+            Logger::getInstance().printReport("[吞吐低谷] 第 " + std::to_string(result.round_index) + " 轮 | " + line.str());
+        }
+    }
+    if (dips > MAX_REPORTED_DIPS) {
+        Logger::getInstance().printReport("[吞吐低谷] 另有 " + std::to_string(dips - MAX_REPORTED_DIPS) +
+            " 个低谷区间，完整对齐序列见日志文件 [Timeline]");
+    }
+}
+
+void MetricsReport::printNetwork(const TestRoundResult& result) {
+    const NetCounters& start = result.start_metrics.net;
+    const NetCounters& end = result.end_metrics.net;
+    if (!(start.available && end.available) && !(start.protocol_available && end.protocol_available)) {
+        return;
+    }
+    Logger::getInstance().printReport("[网络] 第 " + std::to_string(result.round_index) + " 轮 | " +
+        NetMetrics::formatDelta(start, end));
+
+    // 丢包归因：协议计数为全机累计，同机其他 UDP 流量也会计入，只作为判断依据
+    const uint64_t lost = result.sequence.lost;
+    if (lost == 0 || !(start.protocol_available && end.protocol_available)) {
+        return;
     }
+    const unsigned long long rcvbuf = NetMetrics::delta(start.udp_rcvbuf_errors, end.udp_rcvbuf_errors);
+    const unsigned long long in_errors = NetMetrics::delta(start.udp_in_errors, end.udp_in_errors);
+    const unsigned long long nic_dropped = end.available && start.available
+        ? NetMetrics::delta(start.rx_dropped, end.rx_dropped) : 0;
+    std::ostringstream oss;
+    oss << "[丢包归因] 第 " << result.round_index << " 轮 | 序列号丢包: " << lost << " | ";
+    if (rcvbuf > 0 || in_errors > 0) {
+        // RTPS 分片时一个样本对应多个 UDP 报文，计数只能说明内核层确有丢弃
+        oss << "内核 UDP 丢弃 " << (rcvbuf > 0 ? rcvbuf : in_errors)
+            << (rcvbuf > 0 ? " (socket 接收缓冲区溢出)" : " (UDP InErrors)")
+            << "，丢包主要发生在内核 socket 层，可增大接收缓冲区或降低发送速率";
+    }
+    else if (nic_dropped > 0) {
+        oss << "网卡接收丢弃 " << nic_dropped << "，丢包发生在网卡 / 驱动层";
+    }
+    else {
+        oss << "内核与网卡均未记录丢弃，丢包发生在中间件层（如历史缓存 / 资源限制）或发送端";
+    }
+    Logger::getInstance().printReport(oss.str());
+}
+
+void MetricsReport::printPerfCounters(const TestRoundResult& result) {
+    const PerfCounterReport& perf = result.perf;
+    if (!perf.available) {
+        if (!perf.unavailable_reason.empty()) {
+            Logger::getInstance().printReport("[硬件计数] 第 " + std::to_string(result.round_index) +
+                " 轮 | 不可用: " + perf.unavailable_reason);
+        }
+        return;
+    }
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "[硬件计数] 第 " << result.round_index << " 轮 | 样本: " << perf.samples
+        << (perf.thread_wide ? " | 每样本(线程总量摊销)" : " | 每样本");
+    auto append = [&](const char* name, double value) {
+        const double per_sample = perf.perSample(value);
+        if (per_sample >= 0.0) {
+            oss << " " << name << ": " << per_sample;
+        }
+    };
+    append("cycles", perf.cycles);
+    append("instructions", perf.instructions);
+    append("LLC-misses", perf.llc_misses);
+    append("branch-misses", perf.branch_misses);
+    append("context-switches", perf.context_switches);
+    append("page-faults", perf.page_faults);
+    if (perf.ipc() >= 0.0) {
+        oss << " | IPC: " << perf.ipc();
+    }
+    if (perf.user_only) {
+        oss << " | 仅用户态";
+    }
+    if (perf.thread_wide) {
+        oss << " | 含回调外的线程开销";
+    }
+    if (perf.multiplex_ratio < 1.0) {
+        oss << " | 计数器复用 " << perf.multiplex_ratio * 100.0 << "%，已外推";
+    }
+    Logger::getInstance().printReport(oss.str());
+    if (!perf.unavailable_reason.empty()) {
+        Logger::getInstance().log("[硬件计数] 部分计数器未能打开: " + perf.unavailable_reason);
+    }
+}
+
+std::string MetricsReport::formatLatencyLine(const std::string& title, const LatencyHistogram& hist) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << title << " | 样本: " << hist.count()
+        << " | min: " << hist.minNs() / 1000.0 << " us"
+        << " | avg: " << hist.meanNs() / 1000.0 << " us"
+        << " | p50: " << hist.percentileNs(50.0) / 1000.0 << " us"
+        << " | p90: " << hist.percentileNs(90.0) / 1000.0 << " us"
+        << " | p99: " << hist.percentileNs(99.0) / 1000.0 << " us"
+        << " | p99.9: " << hist.percentileNs(99.9) / 1000.0 << " us"
+        << " | max: " << hist.maxNs() / 1000.0 << " us";
+    return oss.str();
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "TestRoundResult.h" // ȷ TestRoundResult 壨 cpu_usage_history
 #include <vector>
 #include <mutex>
+#include <string>
 // ---  ---
 
 // Դ࣬ռ洢ɲִεԴʹժҪ
@@ -17,6 +18,26 @@ public:
     void generateSummary() const;
 
 private:
+    //  CPU ʷƽֵp95 ֵԷֵ븺ֵ
+    static CpuUsageStats computeCpuStats(const std::vector<float>& history);
+
+    // ÿ߳ CPU ռãǰ MAX_REPORTED_THREADS ȱ͵߳
+    static void printThreadUsage(const TestRoundResult& result);
+    static constexpr size_t MAX_REPORTED_THREADS = 5;
+
+    // ԴʱУն°ʱ룬µ͹Դ״
+    static void printResourceTimeline(const TestRoundResult& result);
+    static constexpr size_t MAX_REPORTED_DIPS = 10;
+
+    // նжʱ UDP ջж϶ں˻м
+    static void printNetwork(const TestRoundResult& result);
+
+    // Ӳܼÿһδʱʱԭ
+    static void printPerfCounters(const TestRoundResult& result);
+
+    // ʽһʱӷλus
+    static std::string formatLatencyLine(const std::string& title, const LatencyHistogram& hist);
+
     // 洢ִεĽ
     std::vector<TestRoundResult> results_;
     // ڱ results_ Ļ
@@ -0,0 +1,325 @@
+﻿#include "ResultCompare.h"
+#include "ResultWriter.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+using Row = ResultCompare::Row;
+
+// 拆分一行 CSV（支持双引号转义）
+std::vector<std::string> split_csv(const std::string& line) {
+    std::vector<std::string> fields;
+    std::string field;
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            }
+            else if (c == '"') {
+                quoted = false;
+            }
+            else {
+                field += c;
+            }
+        }
+        else if (c == '"') {
+            quoted = true;
+        }
+        else if (c == ',') {
+            fields.push_back(field);
+            field.clear();
+        }
+        else if (c != '\r') {
+            field += c;
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+double to_number(const std::string& text) {
+    if (text.empty()) return -1.0;
+    char* end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    return end != text.c_str() ? value : -1.0;
+}
+
+std::vector<double> split_series(const std::string& text) {
+    std::vector<double> values;
+    std::istringstream iss(text);
+    std::string item;
+    while (std::getline(iss, item, ResultWriter::SERIES_SEPARATOR)) {
+        const double v = to_number(item);
+        if (v >= 0.0) values.push_back(v);
+    }
+    return values;
+}
+
+bool load_csv(std::ifstream& file, std::vector<Row>& rows, std::string& error) {
+    std::string line;
+    if (!std::getline(file, line)) {
+        error = "文件为空";
+        return false;
+    }
+    std::unordered_map<std::string, size_t> index;
+    const std::vector<std::string> header = split_csv(line);
+    for (size_t i = 0; i < header.size(); ++i) index[header[i]] = i;
+    for (const char* required : { "config", "role", "type", "min_size", "max_size" }) {
+        if (!index.count(required)) {
+            error = std::string("缺少列: ") + required;
+            return false;
+        }
+    }
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line == "\r") continue;
+        const std::vector<std::string> fields = split_csv(line);
+        auto get = [&](const char* name) -> std::string {
+            auto it = index.find(name);
+            return it != index.end() && it->second < fields.size() ? fields[it->second] : std::string();
+        };
+        Row row;
+        row.config = get("config");
+        row.role = get("role");
+        row.type = get("type");
+        row.min_size = static_cast<int>(to_number(get("min_size")));
+        row.max_size = static_cast<int>(to_number(get("max_size")));
+        row.pps = to_number(get("pps"));
+        row.lat_p50_us = to_number(get("lat_p50_us"));
+        row.lat_p99_us = to_number(get("lat_p99_us"));
+        row.interval_pps = split_series(get("interval_pps"));
+        rows.push_back(std::move(row));
+    }
+    return true;
+}
+
+bool load_jsonl(std::ifstream& file, std::vector<Row>& rows, std::string& error) {
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line == "\r") continue;
+        const nlohmann::json item = nlohmann::json::parse(line, nullptr, false);
+        if (item.is_discarded() || !item.is_object()) {
+            error = "第 " + std::to_string(line_no) + " 行不是有效的 JSON 对象";
+            return false;
+        }
+        auto number = [&](const char* name) {
+            auto it = item.find(name);
+            return it != item.end() && it->is_number() ? it->get<double>() : -1.0;
+        };
+        Row row;
+        row.config = item.value("config", "");
+        row.role = item.value("role", "");
+        row.type = item.value("type", "");
+        row.min_size = static_cast<int>(number("min_size"));
+        row.max_size = static_cast<int>(number("max_size"));
+        row.pps = number("pps");
+        row.lat_p50_us = number("lat_p50_us");
+        row.lat_p99_us = number("lat_p99_us");
+        auto series = item.find("interval_pps");
+        if (series != item.end() && series->is_array()) {
+            for (const auto& v : *series) {
+                if (v.is_number()) row.interval_pps.push_back(v.get<double>());
+            }
+        }
+        rows.push_back(std::move(row));
+    }
+    return true;
+}
+
+std::string row_key(const Row& row) {
+    std::string size = std::to_string(row.min_size);
+    if (row.max_size != row.min_size) size += "-" + std::to_string(row.max_size);
+    return row.config + " / " + row.role + " / " + row.type + " / " + size + "B";
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    const size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+} // namespace
+
+bool ResultCompare::loadFile(const std::string& path, std::vector<Row>& rows, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "无法打开文件: " + path;
+        return false;
+    }
+    const bool ok = ResultWriter::formatFromPath(path) == ResultWriter::Format::JsonLines
+        ? load_jsonl(file, rows, error)
+        : load_csv(file, rows, error);
+    if (ok && rows.empty()) {
+        error = "文件中没有结果行: " + path;
+        return false;
+    }
+    if (!ok) {
+        error = path + ": " + error;
+    }
+    return ok;
+}
+
+double ResultCompare::mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+    const size_t n1 = a.size();
+    const size_t n2 = b.size();
+    if (n1 < MIN_TEST_SAMPLES || n2 < MIN_TEST_SAMPLES) {
+        return -1.0;
+    }
+
+    // 合并排序，结并取平均秩
+    std::vector<std::pair<double, int>> all;
+    all.reserve(n1 + n2);
+    for (double v : a) all.emplace_back(v, 0);
+    for (double v : b) all.emplace_back(v, 1);
+    std::sort(all.begin(), all.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+
+    const double n = static_cast<double>(n1 + n2);
+    double rank_sum_a = 0.0;
+    double tie_term = 0.0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) ++j;
+        const double avg_rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+        for (size_t k = i; k < j; ++k) {
+            if (all[k].second == 0) rank_sum_a += avg_rank;
+        }
+        const double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+
+    const double dn1 = static_cast<double>(n1);
+    const double dn2 = static_cast<double>(n2);
+    const double u = rank_sum_a - dn1 * (dn1 + 1.0) / 2.0;
+    const double mean = dn1 * dn2 / 2.0;
+    const double variance = dn1 * dn2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+    if (variance <= 0.0) {
+        return 1.0;   // 全部相同
+    }
+    const double diff = std::fabs(u - mean);
+    const double z = std::max(0.0, diff - 0.5) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+ResultCompare::Report ResultCompare::compare(const std::vector<Row>& baseline, const std::vector<Row>& candidate,
+    const Options& options) {
+    // 同一键的多行（重复轮次 / 同一文件中的多次运行）归为一组
+    std::map<std::string, std::vector<const Row*>> base_groups;
+    std::map<std::string, std::vector<const Row*>> cand_groups;
+    for (const auto& row : baseline) base_groups[row_key(row)].push_back(&row);
+    for (const auto& row : candidate) cand_groups[row_key(row)].push_back(&row);
+
+    Report report;
+    for (const auto& entry : cand_groups) {
+        if (!base_groups.count(entry.first)) {
+            report.unmatched.push_back("仅候选: " + entry.first);
+        }
+    }
+
+    for (const auto& entry : base_groups) {
+        auto cand = cand_groups.find(entry.first);
+        if (cand == cand_groups.end()) {
+            report.unmatched.push_back("仅基线: " + entry.first);
+            continue;
+        }
+
+        struct Metric {
+            const char* name;
+            double Row::* field;
+            bool higher_is_better;
+        };
+        static const Metric metrics[] = {
+            { "pps", &Row::pps, true },
+            { "lat_p50_us", &Row::lat_p50_us, false },
+            { "lat_p99_us", &Row::lat_p99_us, false },
+        };
+
+        for (const Metric& metric : metrics) {
+            std::vector<double> base_rounds, cand_rounds;
+            std::vector<double> base_intervals, cand_intervals;
+            for (const Row* row : entry.second) {
+                if (row->*metric.field < 0.0) continue;
+                base_rounds.push_back(row->*metric.field);
+                if (metric.field == &Row::pps) {
+                    base_intervals.insert(base_intervals.end(), row->interval_pps.begin(), row->interval_pps.end());
+                }
+            }
+            for (const Row* row : cand->second) {
+                if (row->*metric.field < 0.0) continue;
+                cand_rounds.push_back(row->*metric.field);
+                if (metric.field == &Row::pps) {
+                    cand_intervals.insert(cand_intervals.end(), row->interval_pps.begin(), row->interval_pps.end());
+                }
+            }
+            if (base_rounds.empty() || cand_rounds.empty()) {
+                continue;
+            }
+
+            Comparison c;
+            c.key = entry.first;
+            c.metric = metric.name;
+            c.higher_is_better = metric.higher_is_better;
+            c.baseline_rounds = base_rounds.size();
+            c.candidate_rounds = cand_rounds.size();
+            c.baseline_median = median(base_rounds);
+            c.candidate_median = median(cand_rounds);
+            c.delta_percent = c.baseline_median > 0.0
+                ? (c.candidate_median - c.baseline_median) / c.baseline_median * 100.0 : 0.0;
+
+            // 检验样本：吞吐优先用区间序列（样本多），否则用各轮值
+            const bool use_intervals = base_intervals.size() >= MIN_TEST_SAMPLES && cand_intervals.size() >= MIN_TEST_SAMPLES;
+            const std::vector<double>& base_samples = use_intervals ? base_intervals : base_rounds;
+            const std::vector<double>& cand_samples = use_intervals ? cand_intervals : cand_rounds;
+            c.baseline_samples = base_samples.size();
+            c.candidate_samples = cand_samples.size();
+            c.p_value = mannWhitneyP(base_samples, cand_samples);
+
+            const double worse_percent = metric.higher_is_better ? -c.delta_percent : c.delta_percent;
+            const bool significant = c.p_value < 0.0 || c.p_value < options.alpha;
+            c.regression = worse_percent > options.threshold_percent && significant;
+            c.improvement = -worse_percent > options.threshold_percent && significant;
+            if (c.regression) ++report.regressions;
+            report.comparisons.push_back(c);
+        }
+    }
+    return report;
+}
+
+void ResultCompare::print(const Report& report, const Options& options, std::ostream& os) {
+    os << std::fixed << std::setprecision(2)
+        << "=== 结果对比 | 回退阈值: " << options.threshold_percent << "% | 显著性水平: "
+        << std::setprecision(3) << options.alpha << " ===" << std::endl;
+    for (const auto& c : report.comparisons) {
+        os << std::setprecision(2)
+            << (c.regression ? "[回退] " : (c.improvement ? "[提升] " : "[持平] "))
+            << c.key << " | " << c.metric << " 基线: " << c.baseline_median << " (" << c.baseline_rounds << " 轮)"
+            << " -> 候选: " << c.candidate_median << " (" << c.candidate_rounds << " 轮)"
+            << " | 变化: " << std::showpos << c.delta_percent << std::noshowpos << "%";
+        if (c.p_value >= 0.0) {
+            os << std::setprecision(4) << " | p=" << c.p_value
+                << " (n=" << c.baseline_samples << "/" << c.candidate_samples << ")";
+        }
+        else {
+            os << " | 样本不足，仅按阈值判定";
+        }
+        os << std::endl;
+    }
+    for (const auto& key : report.unmatched) {
+        os << "[未匹配] " << key << std::endl;
+    }
+    os << "共 " << report.comparisons.size() << " 项对比，回退 " << report.regressions << " 项" << std::endl;
+}
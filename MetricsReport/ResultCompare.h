@@ -0,0 +1,67 @@
+﻿// ResultCompare.h
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 结果文件对比（compare 模式）：读取两个由 ResultWriter 生成的结果文件（CSV 或 JSON Lines），
+// 按 (配置名, 角色, 类型, 数据大小) 匹配各轮结果，计算中位数变化并做 Mann-Whitney U 检验。
+// 吞吐行比较 pps（越高越好，检验样本优先用区间吞吐序列），时延行比较 p50 / p99（越低越好，检验样本为各轮值）。
+// 变差超过阈值且检验显著（或样本不足以检验）时判为回退。
+class ResultCompare {
+public:
+    struct Options {
+        double threshold_percent = 5.0;   // 回退阈值（相对基线中位数的百分比）
+        double alpha = 0.05;              // 显著性水平
+    };
+
+    // 结果文件中的一行（只保留对比需要的列，缺失值为 -1）
+    struct Row {
+        std::string config;
+        std::string role;
+        std::string type;
+        int min_size = 0;
+        int max_size = 0;
+        double pps = -1.0;
+        double lat_p50_us = -1.0;
+        double lat_p99_us = -1.0;
+        std::vector<double> interval_pps;
+    };
+
+    struct Comparison {
+        std::string key;                  // 配置 / 角色 / 类型 / 大小
+        std::string metric;               // "pps" / "lat_p50_us" / "lat_p99_us"
+        bool higher_is_better = true;
+        size_t baseline_rounds = 0;
+        size_t candidate_rounds = 0;
+        double baseline_median = 0.0;
+        double candidate_median = 0.0;
+        double delta_percent = 0.0;       // (候选 - 基线) / 基线 * 100
+        size_t baseline_samples = 0;      // 参与检验的样本数
+        size_t candidate_samples = 0;
+        double p_value = -1.0;            // -1 表示样本不足，未检验
+        bool regression = false;
+        bool improvement = false;
+    };
+
+    struct Report {
+        std::vector<Comparison> comparisons;
+        std::vector<std::string> unmatched;   // 只出现在一侧的键
+        size_t regressions = 0;
+    };
+
+    // 读取结果文件，格式按扩展名判断（同 ResultWriter）
+    static bool loadFile(const std::string& path, std::vector<Row>& rows, std::string& error);
+
+    static Report compare(const std::vector<Row>& baseline, const std::vector<Row>& candidate, const Options& options);
+
+    static void print(const Report& report, const Options& options, std::ostream& os);
+
+    // 双侧 Mann-Whitney U 检验（正态近似，含结并与连续性校正），返回 p 值；
+    // 任一组少于 MIN_TEST_SAMPLES 个样本时返回 -1。
+    // 注意：区间吞吐样本之间存在自相关，p 值偏乐观，宜配合阈值使用
+    static double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b);
+    static constexpr size_t MIN_TEST_SAMPLES = 3;
+};
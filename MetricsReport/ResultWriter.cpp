@@ -0,0 +1,336 @@
+﻿#include "ResultWriter.h"
+#include "Logger.h"
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+std::string format_number(double value, int precision = 3) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(precision) << value;
+    return oss.str();
+}
+
+std::string now_string() {
+    const std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm_buf{};
+#ifdef _WIN32
+    localtime_s(&tm_buf, &t);
+#else
+    localtime_r(&t, &tm_buf);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&tm_buf, "%Y-%m-%dT%H:%M:%S");
+    return oss.str();
+}
+
+std::string csv_escape(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+        return value;
+    }
+    std::string out = "\"";
+    for (char c : value) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+    return out;
+}
+
+std::string json_escape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size() + 2);
+    for (char c : value) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default: out += c; break;
+        }
+    }
+    return out;
+}
+
+std::string csv_header(const std::vector<std::string>& names) {
+    std::string header;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (i > 0) header += ',';
+        header += names[i];
+    }
+    return header;
+}
+
+// 文件不存在或为空视为可用；否则首行须与 header 完全一致
+bool csv_header_matches(const std::filesystem::path& file, const std::string& header) {
+    std::error_code ec;
+    if (!std::filesystem::exists(file, ec) || std::filesystem::file_size(file, ec) == 0) {
+        return true;
+    }
+    std::ifstream in(file, std::ios::binary);
+    std::string first_line;
+    if (!in.is_open() || !std::getline(in, first_line)) {
+        return false;
+    }
+    if (!first_line.empty() && first_line.back() == '\r') {
+        first_line.pop_back();
+    }
+    return first_line == header;
+}
+
+} // namespace
+
+const std::vector<std::string>& ResultWriter::columns() {
+    static const std::vector<std::string> names = {
+        "run_time", "config", "role", "type",
+        "dpf_qos", "dp_qos", "pub_qos", "sub_qos", "writer_qos", "reader_qos",
+        "round", "min_size", "max_size", "send_count",
+        "packets", "pps", "mbps", "wire_mbps", "lost", "loss_rate",
+        "lat_count", "lat_min_us", "lat_mean_us", "lat_p50_us", "lat_p90_us", "lat_p99_us", "lat_p999_us", "lat_max_us",
+        "cpu_avg", "cpu_p95", "cpu_peak",
+        "ws_end_kb", "private_end_kb", "pool_peak_kb",
+        "interval_ms", "interval_pps",
+        "lat_buckets"
+    };
+    return names;
+}
+
+ResultWriter::Format ResultWriter::formatFromPath(const std::string& path) {
+    const std::string ext = std::filesystem::path(path).extension().string();
+    return (ext == ".jsonl" || ext == ".json") ? Format::JsonLines : Format::Csv;
+}
+
+ResultWriter::ResultWriter(const std::string& path, const ConfigData& config)
+    : path_(path), format_(formatFromPath(path)), config_(config), run_time_(now_string()) {
+}
+
+ResultWriter::~ResultWriter() {
+    flush();
+}
+
+void ResultWriter::addRound(const TestRoundResult& result) {
+    auto text = [](const std::string& v) { Field f; f.value = v; f.is_string = true; return f; };
+    auto number = [](const std::string& v) { Field f; f.value = v; return f; };
+    auto null = []() { Field f; f.is_null = true; return f; };
+
+    const int index = result.round_index - 1;   // round_index 从 1 开始
+    auto config_value = [&](const std::vector<int>& values) {
+        return index >= 0 && index < static_cast<int>(values.size()) ? number(std::to_string(values[index])) : null();
+    };
+    const bool publisher = config_.m_isPositive;
+    const int min_size = index >= 0 && index < static_cast<int>(config_.m_minSize.size()) ? config_.m_minSize[index] : 0;
+    const int max_size = index >= 0 && index < static_cast<int>(config_.m_maxSize.size()) ? config_.m_maxSize[index] : 0;
+
+    std::vector<Field> row;
+    row.reserve(columns().size());
+    row.push_back(text(run_time_));
+    row.push_back(text(config_.name));
+    row.push_back(text(publisher ? "pub" : "sub"));
+    row.push_back(text(config_.m_typeName));
+    row.push_back(text(config_.m_dpfQosName));
+    row.push_back(text(config_.m_dpQosName));
+    row.push_back(text(config_.m_pubQosName));
+    row.push_back(text(config_.m_subQosName));
+    row.push_back(text(config_.m_writerQosName));
+    row.push_back(text(config_.m_readerQosName));
+    row.push_back(number(std::to_string(result.round_index)));
+    row.push_back(config_value(config_.m_minSize));
+    row.push_back(config_value(config_.m_maxSize));
+    row.push_back(config_value(config_.m_sendCount));
+
+    // 吞吐：接收端取整轮汇总，发送端取限速器统计的实际发送速率（定长时折算 Mbps）
+    if (result.receive.packets > 0) {
+        row.push_back(number(std::to_string(result.receive.packets)));
+        row.push_back(number(format_number(result.receive.pps)));
+        row.push_back(number(format_number(result.receive.goodput_mbps)));
+        row.push_back(number(format_number(result.receive.wire_mbps)));
+    }
+    else if (publisher && result.pacing.achieved_rate_pps > 0.0) {
+        row.push_back(null());
+        row.push_back(number(format_number(result.pacing.achieved_rate_pps)));
+        row.push_back(min_size == max_size && min_size > 0
+            ? number(format_number(result.pacing.achieved_rate_pps * min_size * 8.0 / (1024.0 * 1024.0)))
+            : null());
+        row.push_back(null());
+    }
+    else {
+        row.push_back(null());
+        row.push_back(null());
+        row.push_back(null());
+        row.push_back(null());
+    }
+
+    // 丢包：按序列号统计，仅接收端
+    if (result.sequence.received > 0 || result.sequence.lost > 0) {
+        const uint64_t expected = result.sequence.unique + result.sequence.lost;
+        row.push_back(number(std::to_string(result.sequence.lost)));
+        row.push_back(number(format_number(expected > 0 ? 100.0 * result.sequence.lost / expected : 0.0, 4)));
+    }
+    else {
+        row.push_back(null());
+        row.push_back(null());
+    }
+
+    // 时延分位数 (us)：仅时延测试的发送端
+    const LatencyHistogram* lat = result.latency.get();
+    if (lat && !lat->empty()) {
+        row.push_back(number(std::to_string(lat->count())));
+        row.push_back(number(format_number(lat->minNs() / 1000.0)));
+        row.push_back(number(format_number(lat->meanNs() / 1000.0)));
+        row.push_back(number(format_number(lat->percentileNs(50.0) / 1000.0)));
+        row.push_back(number(format_number(lat->percentileNs(90.0) / 1000.0)));
+        row.push_back(number(format_number(lat->percentileNs(99.0) / 1000.0)));
+        row.push_back(number(format_number(lat->percentileNs(99.9) / 1000.0)));
+        row.push_back(number(format_number(lat->maxNs() / 1000.0)));
+    }
+    else {
+        for (int i = 0; i < 8; ++i) row.push_back(null());
+    }
+
+    // CPU / 内存
+    const CpuUsageStats& cpu = result.cpu_stats;
+    row.push_back(cpu.samples > 0 ? number(format_number(cpu.avg)) : null());
+    row.push_back(cpu.samples > 0 ? number(format_number(cpu.p95)) : null());
+    row.push_back(result.end_metrics.cpu_usage_percent_peak >= 0.0
+        ? number(format_number(result.end_metrics.cpu_usage_percent_peak)) : null());
+    row.push_back(number(std::to_string(result.end_metrics.system_working_set_kb)));
+    row.push_back(number(std::to_string(result.end_metrics.system_private_usage_kb)));
+    row.push_back(number(std::to_string(result.end_metrics.memory_peak_kb)));
+
+    // 区间吞吐序列（不含最后一个不完整区间），供 compare 模式做显著性检验
+    const auto& series = result.throughput_series;
+    if (result.throughput_stats.intervals > 0) {
+        row.push_back(number(format_number(result.throughput_stats.interval_ms, 1)));
+        Field values;
+        values.is_array = true;
+        const size_t full = series.size() > 1 ? series.size() - 1 : series.size();
+        for (size_t i = 0; i < full; ++i) {
+            if (i > 0) values.value += SERIES_SEPARATOR;
+            values.value += format_number(series[i].pps, 1);
+        }
+        row.push_back(values);
+    }
+    else {
+        row.push_back(null());
+        row.push_back(null());
+    }
+
+    // 时延直方图的非空桶（"下界ns:计数"），可离线合并多轮或重算任意分位数
+    if (lat && !lat->empty()) {
+        Field buckets;
+        buckets.is_string = true;
+        lat->appendBuckets(buckets.value, SERIES_SEPARATOR);
+        row.push_back(buckets);
+    }
+    else {
+        row.push_back(null());
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (format_ == Format::Csv) {
+        appendCsv(row);
+    }
+    else {
+        appendJson(row);
+    }
+    ++buffered_rows_;
+}
+
+void ResultWriter::appendCsv(const std::vector<Field>& row) {
+    for (size_t i = 0; i < row.size(); ++i) {
+        if (i > 0) buffer_ += ',';
+        if (!row[i].is_null) buffer_ += csv_escape(row[i].value);
+    }
+    buffer_ += '\n';
+}
+
+void ResultWriter::appendJson(const std::vector<Field>& row) {
+    const auto& names = columns();
+    buffer_ += '{';
+    for (size_t i = 0; i < row.size(); ++i) {
+        if (i > 0) buffer_ += ',';
+        buffer_ += '"' + names[i] + "\":";
+        const Field& f = row[i];
+        if (f.is_null) {
+            buffer_ += "null";
+        }
+        else if (f.is_string) {
+            buffer_ += '"' + json_escape(f.value) + '"';
+        }
+        else if (f.is_array) {
+            buffer_ += '[';
+            for (char c : f.value) buffer_ += (c == SERIES_SEPARATOR ? ',' : c);
+            buffer_ += ']';
+        }
+        else {
+            buffer_ += f.value;
+        }
+    }
+    buffer_ += "}\n";
+}
+
+void ResultWriter::resolveCsvPath() {
+    path_resolved_ = true;
+    const std::string header = csv_header(columns());
+    const std::filesystem::path original(path_);
+    if (csv_header_matches(original, header)) {
+        return;
+    }
+
+    // 旧版本写出的文件列不同，继续追加会使各行错列：改用 <名>_<N>.csv，同版本多次运行仍追加到同一文件
+    const std::filesystem::path parent = original.parent_path();
+    const std::string stem = original.stem().string();
+    const std::string ext = original.extension().string();
+    for (int n = 1;; ++n) {
+        const std::filesystem::path candidate = parent / (stem + "_" + std::to_string(n) + ext);
+        if (csv_header_matches(candidate, header)) {
+            path_ = candidate.string();
+            break;
+        }
+    }
+    Logger::getInstance().logAndPrint(
+        "[Result] 警告: " + original.string() + " 的表头与当前列定义不一致，结果改写到 " + path_
+    );
+}
+
+bool ResultWriter::flush() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (buffer_.empty()) {
+        return true;
+    }
+    if (format_ == Format::Csv && !path_resolved_) {
+        resolveCsvPath();
+    }
+
+    std::error_code ec;
+    const std::filesystem::path file(path_);
+    if (file.has_parent_path()) {
+        std::filesystem::create_directories(file.parent_path(), ec);
+    }
+    const bool new_file = !std::filesystem::exists(file, ec) || std::filesystem::file_size(file, ec) == 0;
+
+    std::ofstream out(file, std::ios::binary | std::ios::app);
+    if (!out.is_open()) {
+        Logger::getInstance().logAndPrint("[Result] 无法打开结果文件: " + path_);
+        return false;
+    }
+    if (new_file && format_ == Format::Csv) {
+        out << csv_header(columns()) << '\n';
+    }
+    out << buffer_;
+    out.flush();
+    if (!out) {
+        Logger::getInstance().logAndPrint("[Result] 写入结果文件失败: " + path_);
+        return false;
+    }
+
+    Logger::getInstance().log("[Result] 已写入 " + std::to_string(buffered_rows_) + " 行: " + path_);
+    buffer_.clear();
+    buffered_rows_ = 0;
+    return true;
+}
@@ -0,0 +1,62 @@
+﻿// ResultWriter.h
+#pragma once
+
+#include "ConfigData.h"
+#include "TestRoundResult.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 机器可读的结果文件：每轮一行，CSV 或 JSON Lines（按扩展名 .jsonl / .json 选择，其余为 CSV）。
+// addRound 只把一行格式化到内存缓冲，flush 才做文件 I/O，由调用方放在测量窗口之外（每轮清理之后）。
+// 文件以追加方式写入，CSV 仅在新文件时写表头；不适用的字段 CSV 留空、JSON 为 null。
+// 追加到已有 CSV 前先核对表头：与 columns() 不一致（列有增删）时改写到 <名>_<N>.csv 并提示。
+class ResultWriter {
+public:
+    enum class Format { Csv, JsonLines };
+
+    ResultWriter(const std::string& path, const ConfigData& config);
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    // 格式化一轮结果到内存缓冲（可在轮次回调中调用）
+    void addRound(const TestRoundResult& result);
+
+    // 把缓冲追加写入文件；失败时保留缓冲并返回 false
+    bool flush();
+
+    const std::string& path() const { return path_; }
+    Format format() const { return format_; }
+
+    static Format formatFromPath(const std::string& path);
+
+    // 列名（CSV 表头顺序，同时是 JSON 的键）
+    static const std::vector<std::string>& columns();
+
+    // 区间吞吐序列、时延直方图桶在 CSV 单元格内的分隔符
+    static constexpr char SERIES_SEPARATOR = ';';
+
+private:
+    struct Field {
+        std::string value;
+        bool is_string = false;
+        bool is_null = false;
+        bool is_array = false;   // value 为 SERIES_SEPARATOR 分隔的数值
+    };
+
+    void appendCsv(const std::vector<Field>& row);
+    void appendJson(const std::vector<Field>& row);
+    // 首次 flush 时确定 CSV 实际写入路径（表头不一致则换文件）
+    void resolveCsvPath();
+
+    std::string path_;
+    Format format_;
+    ConfigData config_;
+    std::string run_time_;         // 本次运行的开始时间，区分同一文件中的多次运行
+    std::string buffer_;
+    size_t buffered_rows_ = 0;
+    bool path_resolved_ = false;
+    std::mutex mtx_;
+};
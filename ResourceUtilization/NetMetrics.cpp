@@ -0,0 +1,193 @@
+﻿#include "NetMetrics.h"
+
+#ifdef _WIN32
+// winsock2 必须先于 windows.h 引入
+#include <winsock2.h>
+#include <ws2ipdef.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#pragma comment(lib, "iphlpapi.lib")
+#else
+#include <filesystem>
+#include <fstream>
+#endif
+
+#include <sstream>
+
+namespace {
+
+#ifdef _WIN32
+std::string wide_to_utf8(const wchar_t* wstr) {
+    const int size = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, nullptr, 0, nullptr, nullptr);
+    if (size <= 1) return std::string();
+    std::string out(static_cast<size_t>(size - 1), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, wstr, -1, &out[0], size, nullptr, nullptr);
+    return out;
+}
+
+bool read_interfaces(const std::string& interface_name, NetCounters& out) {
+    PMIB_IF_TABLE2 table = nullptr;
+    if (GetIfTable2(&table) != NO_ERROR || !table) {
+        return false;
+    }
+    bool matched = false;
+    for (ULONG i = 0; i < table->NumEntries; ++i) {
+        const MIB_IF_ROW2& row = table->Table[i];
+        if (interface_name.empty()) {
+            // 同一物理网卡会以多个过滤层接口出现，只统计硬件接口
+            if (row.Type == IF_TYPE_SOFTWARE_LOOPBACK || row.OperStatus != IfOperStatusUp ||
+                !row.InterfaceAndOperStatusFlags.HardwareInterface) {
+                continue;
+            }
+        }
+        else if (wide_to_utf8(row.Alias) != interface_name && wide_to_utf8(row.Description) != interface_name) {
+            continue;
+        }
+        out.rx_bytes += row.InOctets;
+        out.tx_bytes += row.OutOctets;
+        out.rx_packets += row.InUcastPkts + row.InNUcastPkts;
+        out.tx_packets += row.OutUcastPkts + row.OutNUcastPkts;
+        out.rx_dropped += row.InDiscards;
+        out.tx_dropped += row.OutDiscards;
+        out.rx_errors += row.InErrors;
+        out.tx_errors += row.OutErrors;
+        matched = true;
+    }
+    FreeMibTable(table);
+    return matched;
+}
+
+bool read_protocols(NetCounters& out) {
+    MIB_UDPSTATS udp = {};
+    MIB_TCPSTATS tcp = {};
+    if (GetUdpStatisticsEx(&udp, AF_INET) != NO_ERROR || GetTcpStatisticsEx(&tcp, AF_INET) != NO_ERROR) {
+        return false;
+    }
+    out.udp_in_datagrams = udp.dwInDatagrams;
+    out.udp_out_datagrams = udp.dwOutDatagrams;
+    out.udp_in_errors = udp.dwInErrors;
+    out.udp_no_ports = udp.dwNoPorts;
+    out.tcp_retrans_segs = tcp.dwRetransSegs;
+    return true;
+}
+#else
+// 未指定网卡时只统计 up 状态的物理网卡（有 device 链接）；
+// 网桥、veth、tun 等虚拟网卡转发的流量同时出现在物理网卡上，累加会重复计数
+bool is_physical_interface_up(const std::string& name) {
+    const std::string base = "/sys/class/net/" + name;
+    std::error_code ec;
+    if (!std::filesystem::exists(base + "/device", ec)) {
+        return false;
+    }
+    std::ifstream operstate(base + "/operstate");
+    std::string state;
+    return std::getline(operstate, state) && state == "up";
+}
+
+// /proc/net/dev：两行表头，之后每行 "  eth0: rx_bytes rx_packets errs drop fifo frame compressed multicast
+//                                          tx_bytes tx_packets errs drop fifo colls carrier compressed"
+bool read_interfaces(const std::string& interface_name, NetCounters& out) {
+    std::ifstream file("/proc/net/dev");
+    if (!file.is_open()) {
+        return false;
+    }
+    bool matched = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        const size_t begin = line.find_first_not_of(' ');
+        const std::string name = line.substr(begin, colon - begin);
+        if (interface_name.empty() ? !is_physical_interface_up(name) : name != interface_name) continue;
+
+        std::istringstream iss(line.substr(colon + 1));
+        unsigned long long v[16] = {};
+        int fields = 0;
+        while (fields < 16 && iss >> v[fields]) ++fields;
+        if (fields < 12) continue;
+        out.rx_bytes += v[0];
+        out.rx_packets += v[1];
+        out.rx_errors += v[2];
+        out.rx_dropped += v[3];
+        out.tx_bytes += v[8];
+        out.tx_packets += v[9];
+        out.tx_errors += v[10];
+        out.tx_dropped += v[11];
+        matched = true;
+    }
+    return matched;
+}
+
+// /proc/net/snmp：每个协议两行，"Udp: 字段名..." 后紧跟 "Udp: 数值..."
+bool read_protocols(NetCounters& out) {
+    std::ifstream file("/proc/net/snmp");
+    if (!file.is_open()) {
+        return false;
+    }
+    bool udp_found = false;
+    std::string header, values;
+    while (std::getline(file, header) && std::getline(file, values)) {
+        const bool is_udp = header.compare(0, 4, "Udp:") == 0;
+        const bool is_tcp = header.compare(0, 4, "Tcp:") == 0;
+        if (!is_udp && !is_tcp) continue;
+
+        std::istringstream names(header.substr(4));
+        std::istringstream nums(values.substr(values.find(':') + 1));
+        std::string name;
+        long long value = 0;   // Tcp 的 MaxConn 为 -1
+        while (names >> name && nums >> value) {
+            const unsigned long long v = value > 0 ? static_cast<unsigned long long>(value) : 0;
+            if (is_udp) {
+                if (name == "InDatagrams") out.udp_in_datagrams = v;
+                else if (name == "OutDatagrams") out.udp_out_datagrams = v;
+                else if (name == "InErrors") out.udp_in_errors = v;
+                else if (name == "RcvbufErrors") out.udp_rcvbuf_errors = v;
+                else if (name == "SndbufErrors") out.udp_sndbuf_errors = v;
+                else if (name == "NoPorts") out.udp_no_ports = v;
+                udp_found = true;
+            }
+            else if (name == "RetransSegs") {
+                out.tcp_retrans_segs = v;
+            }
+        }
+    }
+    return udp_found;
+}
+#endif
+
+} // namespace
+
+NetCounters NetMetrics::collect(const std::string& interface_name) {
+    NetCounters counters;
+    counters.interface_name = interface_name;
+    counters.available = read_interfaces(interface_name, counters);
+    counters.protocol_available = read_protocols(counters);
+    return counters;
+}
+
+std::string NetMetrics::formatDelta(const NetCounters& start, const NetCounters& end) {
+    std::ostringstream oss;
+    oss << std::fixed;
+    oss.precision(2);
+    if (end.available && start.available) {
+        oss << "网卡[" << (end.interface_name.empty() ? "全部" : end.interface_name) << "] 接收: "
+            << static_cast<double>(delta(start.rx_bytes, end.rx_bytes)) / (1024.0 * 1024.0) << " MB / "
+            << delta(start.rx_packets, end.rx_packets) << " 包, 发送: "
+            << static_cast<double>(delta(start.tx_bytes, end.tx_bytes)) / (1024.0 * 1024.0) << " MB / "
+            << delta(start.tx_packets, end.tx_packets) << " 包, 丢弃(收/发): "
+            << delta(start.rx_dropped, end.rx_dropped) << " / " << delta(start.tx_dropped, end.tx_dropped)
+            << ", 错误(收/发): " << delta(start.rx_errors, end.rx_errors) << " / " << delta(start.tx_errors, end.tx_errors);
+    }
+    else {
+        oss << "网卡计数: 无数据";
+    }
+    if (end.protocol_available && start.protocol_available) {
+        oss << " | UDP 接收: " << delta(start.udp_in_datagrams, end.udp_in_datagrams)
+            << " 接收错误: " << delta(start.udp_in_errors, end.udp_in_errors)
+            << " 接收缓冲溢出: " << delta(start.udp_rcvbuf_errors, end.udp_rcvbuf_errors)
+            << " 发送缓冲溢出: " << delta(start.udp_sndbuf_errors, end.udp_sndbuf_errors)
+            << " 无端口: " << delta(start.udp_no_ports, end.udp_no_ports)
+            << " | TCP 重传: " << delta(start.tcp_retrans_segs, end.tcp_retrans_segs);
+    }
+    return oss.str();
+}
@@ -0,0 +1,22 @@
+﻿// NetMetrics.h
+#pragma once
+
+#include "SysMetrics.h"
+#include <string>
+
+// 网络计数采集（静态工具类）：网卡收发/丢弃计数 + UDP/TCP 协议计数。
+// 独立成单独的编译单元，避免 iphlpapi / winsock2 与 ResourceUtilization.h 中的 windows.h 冲突。
+class NetMetrics {
+public:
+    // 读取累计计数；interface_name 为空时累加全部处于 up 状态的物理网卡（不含回环与虚拟网卡）。
+    // 网卡与协议计数分别读取，任一失败只清除对应的 available 标志
+    static NetCounters collect(const std::string& interface_name);
+
+    // 一行轮次增量描述（end - start），用于报告
+    static std::string formatDelta(const NetCounters& start, const NetCounters& end);
+
+    // 计数器回绕或网卡重置时按 0 处理
+    static unsigned long long delta(unsigned long long start, unsigned long long end) {
+        return end >= start ? end - start : 0;
+    }
+};
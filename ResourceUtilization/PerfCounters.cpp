@@ -0,0 +1,156 @@
+﻿#include "PerfCounters.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+
+const char* const COUNTER_NAMES[PerfCounters::COUNTER_NUM] = {
+    "cycles", "instructions", "LLC-misses", "branch-misses", "context-switches", "page-faults"
+};
+
+#ifdef __linux__
+struct CounterDef {
+    uint32_t type;
+    uint64_t config;
+};
+
+const CounterDef COUNTER_DEFS[PerfCounters::COUNTER_NUM] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+};
+
+// pid = 0, cpu = -1：调用线程，在任意 CPU 上
+int open_counter(const CounterDef& def, bool exclude_kernel) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = def.type;
+    attr.config = def.config;
+    attr.disabled = 1;
+    attr.exclude_hv = 1;
+    attr.exclude_kernel = exclude_kernel ? 1 : 0;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds_) fd = -1;
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+bool PerfCounters::open() {
+    close();
+    last_error_.clear();
+#ifdef __linux__
+    user_only_ = false;
+    int opened = 0;
+    for (int i = 0; i < COUNTER_NUM; ++i) {
+        const int fd = open_counter(COUNTER_DEFS[i], user_only_);
+        if (fd < 0 && (errno == EACCES || errno == EPERM) && !user_only_) {
+            // perf_event_paranoid >= 2 时只允许统计用户态：已打开的计数器含内核态，
+            // 全部关闭后从头按用户态重新打开，保证各项统计口径一致
+            user_only_ = true;
+            close();
+            last_error_.clear();
+            opened = 0;
+            i = -1;
+            continue;
+        }
+        if (fd < 0) {
+            if (!last_error_.empty()) last_error_ += "; ";
+            last_error_ += std::string(COUNTER_NAMES[i]) + ": " + std::strerror(errno);
+            continue;
+        }
+        fds_[i] = fd;
+        ++opened;
+    }
+    return opened > 0;
+#else
+    last_error_ = "perf_event_open 仅在 Linux 上可用";
+    return false;
+#endif
+}
+
+void PerfCounters::close() {
+#ifdef __linux__
+    for (int& fd : fds_) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+#endif
+}
+
+bool PerfCounters::isOpen() const {
+    for (int fd : fds_) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+}
+
+PerfCounterReport PerfCounters::report(uint64_t samples) const {
+    PerfCounterReport out;
+    out.samples = samples;
+    out.user_only = user_only_;
+    out.unavailable_reason = last_error_;
+    double* values[COUNTER_NUM] = {
+        &out.cycles, &out.instructions, &out.llc_misses,
+        &out.branch_misses, &out.context_switches, &out.page_faults
+    };
+#ifdef __linux__
+    for (int i = 0; i < COUNTER_NUM; ++i) {
+        if (fds_[i] < 0) continue;
+        uint64_t buf[3] = { 0, 0, 0 };   // value, time_enabled, time_running
+        if (read(fds_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) continue;
+        double value = static_cast<double>(buf[0]);
+        if (buf[2] > 0 && buf[2] < buf[1]) {
+            // 计数器被复用时按实际运行时间外推
+            const double ratio = static_cast<double>(buf[2]) / static_cast<double>(buf[1]);
+            value /= ratio;
+            out.multiplex_ratio = std::min(out.multiplex_ratio, ratio);
+        }
+        *values[i] = value;
+        out.available = true;
+    }
+#else
+    (void)values;
+#endif
+    return out;
+}
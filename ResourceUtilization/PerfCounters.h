@@ -0,0 +1,47 @@
+﻿// PerfCounters.h
+#pragma once
+
+#include "SysMetrics.h"
+#include <cstdint>
+#include <string>
+
+// 单线程硬件性能计数器（Linux perf_event_open）：只统计调用 open() 的线程。
+// 各计数器独立打开，某一项不受支持（如虚拟机中的 LLC）不影响其余项；
+// 全部失败（非 Linux、perf_event_paranoid 禁止等）时 report().available 为 false，测试照常进行。
+class PerfCounters {
+public:
+    enum Counter {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        CONTEXT_SWITCHES,
+        PAGE_FAULTS,
+        COUNTER_NUM
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // 为调用线程打开计数器（已打开则先关闭）；至少一项成功即返回 true，失败原因见 lastError()
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    // 清零并开始 / 停止计数；开始与停止可以在不同线程调用
+    void start();
+    void stop();
+
+    // 读取当前计数（按复用比例缩放），samples 用于换算每样本数值
+    PerfCounterReport report(uint64_t samples) const;
+
+    const std::string& lastError() const { return last_error_; }
+
+private:
+    int fds_[COUNTER_NUM];
+    bool user_only_ = false;   // perf_event_paranoid 不允许统计内核态时退化为只统计用户态
+    std::string last_error_;
+};
@@ -1,27 +1,39 @@
 ﻿#include "ResourceUtilization.h"
 #include "GloMemPool.h" // 用于获取内存 stats
 #include "Logger.h"     // 用于输出调试日志
+#include "NetMetrics.h" // 网卡与 UDP/TCP 计数
 
 // Windows 平台特定头文件
 #ifdef _WIN32
 #include <windows.h>
 // --- 新增：包含 psapi.h 以使用 GetProcessMemoryInfo ---
 #include <psapi.h> // 包含 GetProcessMemoryInfo 所需的头文件
+#include <tlhelp32.h> // 枚举进程内线程（每线程 CPU 统计）
 #pragma comment(lib, "psapi.lib") // 链接 psapi.lib 库
 // --- 新增结束 ---
-#include <sstream>      // 用于格式化错误信息
-#include <chrono>       // 用于时间间隔控制
-#include <thread>       // 用于后台采样线程
-#include <atomic>       // 用于线程安全的峰值存储
-#include <algorithm>    // 用于 std::max
-#include <string>       // for std::string, needed for WideCharToMultiByte conversion
 // --- 新增：PDH 头文件 ---
 #include <pdh.h>
 #include <pdhmsg.h>
 #pragma comment(lib, "pdh.lib")
 // --- 新增结束 ---
+#else
+// Linux 平台：CPU 与内存信息来自 /proc，峰值 RSS 兜底来自 getrusage
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 
+#include <sstream>      // 用于格式化错误信息
+#include <chrono>       // 用于时间间隔控制
+#include <thread>       // 用于后台采样线程
+#include <atomic>       // 用于线程安全的峰值存储
+#include <mutex>        // 用于保护 CPU 历史环形缓冲区
+#include <unordered_map>
+#include <algorithm>    // 用于 std::max
+#include <string>       // for std::string, needed for WideCharToMultiByte conversion
 #include <vector> // 确保包含 vector
 
 // -----------------------------
@@ -50,32 +62,32 @@ public:
 
     // 内部初始化函数
     bool initialize_internal() {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Starting initialization (Peak GetProcessTimes method)...");
+        LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Starting initialization (Peak GetProcessTimes method)...");
 
         // 如果已经初始化，直接返回成功
         if (is_initialized_) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Already initialized.");
+            LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Already initialized.");
             return true;
         }
 
 #ifdef _WIN32
         // 获取当前进程 ID
         pid_ = GetCurrentProcessId();
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Current Process ID: " + std::to_string(pid_));
+        LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Current Process ID: " + std::to_string(pid_));
 
         // 获取当前进程句柄 (伪句柄，无需 CloseHandle)
         process_handle_ = GetCurrentProcess();
         if (process_handle_ == NULL) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Error: Failed to get current process handle.");
+            LOG_ERROR("[ResourceUtilization::Impl::initialize_internal] Error: Failed to get current process handle.");
             return false;
         }
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Got process handle.");
+        LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Got process handle.");
 
         // 初始化时获取一次时间，检查 API 可用性
         FILETIME dummy_ft1, dummy_ft2, dummy_ft3, dummy_ft4;
         if (!GetSystemTimes(&dummy_ft1, &dummy_ft2, &dummy_ft3) ||
             !GetProcessTimes(process_handle_, &dummy_ft1, &dummy_ft2, &dummy_ft3, &dummy_ft4)) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Error: Initial GetSystemTimes or GetProcessTimes failed.");
+            LOG_ERROR("[ResourceUtilization::Impl::initialize_internal] Error: Initial GetSystemTimes or GetProcessTimes failed.");
             process_handle_ = NULL;
             return false;
         }
@@ -84,48 +96,76 @@ public:
         stop_sampling_ = false;
         current_cpu_peak_ = -1.0; // 重置峰值
         sampling_thread_ = new std::thread(&Impl::sampling_loop, this);
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Sampling thread started.");
+        LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Sampling thread started.");
         // --- 启动结束 ---
 
         // --- 新增：初始化每个核心的监控 ---
         if (!initialize_per_core_internal()) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Warning: Per-core monitoring initialization failed or not supported.");
+            LOG_WARN("[ResourceUtilization::Impl::initialize_internal] Warning: Per-core monitoring initialization failed or not supported.");
             // 可以选择让整体初始化失败，或者继续 (取决于需求)
             // return false; // 如果核心监控是必须的，可以在这里返回 false
         }
         else {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Per-core monitoring initialized.");
+            LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Per-core monitoring initialized.");
         }
         // --- 新增结束 ---
 
         is_initialized_ = true;
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Successfully initialized (Peak GetProcessTimes method).");
+        LOG_INFO("[ResourceUtilization::Impl::initialize_internal] Successfully initialized (Peak GetProcessTimes method).");
         return true;
 
 #else
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_internal] Error: GetProcessTimes method not supported on non-Windows.");
-        return false;
+        pid_ = static_cast<DWORD>(getpid());
+        LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Current Process ID: " + std::to_string(pid_));
+
+        // 初始化时读取一次 /proc，检查可用性（容器或受限环境中可能未挂载 /proc）
+        unsigned long long sys_total = 0, proc_total = 0;
+        if (!read_cpu_times(sys_total, proc_total)) {
+            LOG_ERROR("[ResourceUtilization::Impl::initialize_internal] Error: Initial read of /proc/stat or /proc/self/stat failed.");
+            return false;
+        }
+
+        // --- 启动后台采样线程 ---
+        stop_sampling_ = false;
+        current_cpu_peak_ = -1.0; // 重置峰值
+        peak_private_kb_ = 0;
+        sampling_thread_ = new std::thread(&Impl::sampling_loop, this);
+        LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Sampling thread started.");
+
+        if (!initialize_per_core_internal()) {
+            LOG_WARN("[ResourceUtilization::Impl::initialize_internal] Warning: Per-core monitoring initialization failed or not supported.");
+        }
+        else {
+            LOG_DEBUG("[ResourceUtilization::Impl::initialize_internal] Per-core monitoring initialized.");
+        }
+
+        is_initialized_ = true;
+        LOG_INFO("[ResourceUtilization::Impl::initialize_internal] Successfully initialized (Peak /proc method).");
+        return true;
 #endif
     }
 
     // 内部关闭函数
     void shutdown_internal() {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_internal] Shutting down...");
+        LOG_DEBUG("[ResourceUtilization::Impl::shutdown_internal] Shutting down...");
 
         // --- 停止并等待后台采样线程 ---
         if (sampling_thread_ && sampling_thread_->joinable()) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_internal] Stopping sampling thread...");
+            LOG_DEBUG("[ResourceUtilization::Impl::shutdown_internal] Stopping sampling thread...");
             stop_sampling_ = true;
             sampling_thread_->join();
             delete sampling_thread_;
             sampling_thread_ = nullptr;
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_internal] Sampling thread stopped and joined.");
+            LOG_DEBUG("[ResourceUtilization::Impl::shutdown_internal] Sampling thread stopped and joined.");
         }
         // --- 停止结束 ---
 
+        // 未取走的 CPU 历史随之丢弃
+        stop_recording_internal();
+
         // --- 新增：关闭每个核心的监控 ---
         shutdown_per_core_internal();
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_internal] Per-core monitoring shut down.");
+        LOG_DEBUG("[ResourceUtilization::Impl::shutdown_internal] Per-core monitoring shut down.");
         // --- 新增结束 ---
 
         is_initialized_ = false;
@@ -134,7 +174,7 @@ public:
 #ifdef _WIN32
         process_handle_ = NULL;
 #endif
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_internal] Shutdown complete.");
+        LOG_DEBUG("[ResourceUtilization::Impl::shutdown_internal] Shutdown complete.");
     }
 
     // --- 新增：内部初始化每个核心监控 ---
@@ -149,7 +189,7 @@ public:
 
         PDH_STATUS status = PdhOpenQuery(NULL, 0, &query_);
         if (status != ERROR_SUCCESS) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Error opening PDH query: " + std::to_string(status));
+            LOG_ERROR("[ResourceUtilization::Impl::initialize_per_core_internal] Error opening PDH query: " + std::to_string(status));
             return false;
         }
 
@@ -173,7 +213,7 @@ public:
             PDH_HCOUNTER counter;
             status = PdhAddCounter(query_, path.c_str(), 0, &counter);
             if (status != ERROR_SUCCESS) {
-                Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Error adding counter (" + std::to_string(i) + " - " + wstring_to_string(path) + "): " + std::to_string(status));
+                LOG_ERROR("[ResourceUtilization::Impl::initialize_per_core_internal] Error adding counter (" + std::to_string(i) + " - " + wstring_to_string(path) + "): " + std::to_string(status));
                 fallbackNeeded = true;
                 break; // 如果一个失败，可能需要全部回退
             }
@@ -184,7 +224,7 @@ public:
 
         // 如果 Processor Information 路径失败，回退到 \Processor(<Number>)\% Processor Time
         if (fallbackNeeded) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Falling back to \\Processor(N)\\% Processor Time format.");
+            LOG_WARN("[ResourceUtilization::Impl::initialize_per_core_internal] Falling back to \\Processor(N)\\% Processor Time format.");
             // 清理已添加的计数器和路径
             for (auto c : counters_) PdhRemoveCounter(c);
             counters_.clear();
@@ -203,14 +243,14 @@ public:
                     counters_.push_back(fallbackCounter);
                 }
                 else {
-                    Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Error adding fallback counter (" + std::to_string(k) + " - " + wstring_to_string(fallbackPath) + "): " + std::to_string(status));
+                    LOG_ERROR("[ResourceUtilization::Impl::initialize_per_core_internal] Error adding fallback counter (" + std::to_string(k) + " - " + wstring_to_string(fallbackPath) + "): " + std::to_string(status));
                     // 可以选择失败或跳过该核心，这里选择继续尝试
                 }
             }
         }
 
         if (counters_.empty()) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] No counters could be added.");
+            LOG_ERROR("[ResourceUtilization::Impl::initialize_per_core_internal] No counters could be added.");
             PdhCloseQuery(query_);
             query_ = nullptr;
             return false;
@@ -219,15 +259,30 @@ public:
         // 执行一次初始查询以建立基线
         status = PdhCollectQueryData(query_);
         if (status != ERROR_SUCCESS) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Warning: Error collecting initial PDH  " + std::to_string(status));
+            LOG_WARN("[ResourceUtilization::Impl::initialize_per_core_internal] Warning: Error collecting initial PDH  " + std::to_string(status));
             // 不一定导致初始化失败，但后续第一次查询可能不准
         }
 
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Successfully initialized per-core monitoring for " + std::to_string(counters_.size()) + " cores.");
+        LOG_INFO("[ResourceUtilization::Impl::initialize_per_core_internal] Successfully initialized per-core monitoring for " + std::to_string(counters_.size()) + " cores.");
         return true;
 #else
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::initialize_per_core_internal] Per-core monitoring not implemented for non-Windows.");
-        return false;
+        // 读取一次 /proc/stat 作为基线，之后每次快照与上一次比较（与 PDH 两次 Collect 之间取差值的语义一致）
+        std::vector<CpuLineTimes> lines;
+        if (!read_proc_stat(lines)) {
+            LOG_ERROR("[ResourceUtilization::Impl::initialize_per_core_internal] Error reading /proc/stat.");
+            return false;
+        }
+        prev_core_times_.clear();
+        for (const auto& line : lines) {
+            if (line.core_id >= 0) prev_core_times_.push_back(line);
+        }
+        if (prev_core_times_.empty()) {
+            LOG_ERROR("[ResourceUtilization::Impl::initialize_per_core_internal] No per-core lines found in /proc/stat.");
+            return false;
+        }
+        per_core_ready_ = true;
+        LOG_INFO("[ResourceUtilization::Impl::initialize_per_core_internal] Successfully initialized per-core monitoring for " + std::to_string(prev_core_times_.size()) + " cores.");
+        return true;
 #endif
     }
     // --- 新增结束 ---
@@ -241,7 +296,10 @@ public:
         }
         counters_.clear();
         counterPaths_.clear();
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::shutdown_per_core_internal] Per-core monitoring resources released.");
+        LOG_DEBUG("[ResourceUtilization::Impl::shutdown_per_core_internal] Per-core monitoring resources released.");
+#else
+        per_core_ready_ = false;
+        prev_core_times_.clear();
 #endif
     }
     // --- 新增结束 ---
@@ -251,13 +309,13 @@ public:
         std::vector<PerCoreUsage> coreUsages;
 #ifdef _WIN32
         if (!query_) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error: PDH query not initialized.");
+            LOG_ERROR("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error: PDH query not initialized.");
             return coreUsages; // 返回空
         }
 
         PDH_STATUS status = PdhCollectQueryData(query_);
         if (status != ERROR_SUCCESS) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error collecting PDH  " + std::to_string(status));
+            LOG_ERROR("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error collecting PDH  " + std::to_string(status));
             // 可以选择返回空或添加错误标记的条目
             // return coreUsages;
         }
@@ -288,7 +346,7 @@ public:
                             coreId = static_cast<DWORD>(std::stoi(coreIdStr));
                         }
                         catch (...) {
-                            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Warning: Could not parse core ID from path, using index " + std::to_string(i));
+                            LOG_WARN("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Warning: Could not parse core ID from path, using index " + std::to_string(i));
                             coreId = static_cast<DWORD>(i); // Fallback to index
                         }
                     }
@@ -296,12 +354,36 @@ public:
                 coreUsages.emplace_back(coreId, counterVal.doubleValue);
             }
             else {
-                Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error getting formatted counter value for counter " + std::to_string(i) + ": " + std::to_string(status));
+                LOG_ERROR("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error getting formatted counter value for counter " + std::to_string(i) + ": " + std::to_string(status));
                 // 添加一个表示错误的 CoreUsage 条目
                 DWORD errorCoreId = (i < counterPaths_.size()) ? static_cast<DWORD>(i) : static_cast<DWORD>(i); // 尽量提供 ID
                 coreUsages.emplace_back(errorCoreId, -1.0); // 用 -1.0 表示错误
             }
         }
+#else
+        if (!per_core_ready_) {
+            LOG_ERROR("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error: per-core monitoring not initialized.");
+            return coreUsages;
+        }
+
+        std::vector<CpuLineTimes> lines;
+        if (!read_proc_stat(lines)) {
+            LOG_ERROR("[ResourceUtilization::Impl::get_per_core_usage_snapshot_internal] Error reading /proc/stat.");
+            return coreUsages;
+        }
+
+        std::vector<CpuLineTimes> current;
+        for (const auto& line : lines) {
+            if (line.core_id < 0) continue;
+            current.push_back(line);
+
+            // 按核心 ID 匹配上一次的计数（CPU 热插拔时核心列表可能变化）
+            auto prev = std::find_if(prev_core_times_.begin(), prev_core_times_.end(),
+                [&](const CpuLineTimes& p) { return p.core_id == line.core_id; });
+            const double usage = prev != prev_core_times_.end() ? core_usage_percent(*prev, line) : -1.0;
+            coreUsages.emplace_back(static_cast<DWORD>(line.core_id), usage);
+        }
+        prev_core_times_.swap(current);
 #endif
         return coreUsages;
     }
@@ -311,17 +393,16 @@ public:
     // --- 新增：后台采样循环 ---
     // 在独立线程中高频采样 CPU 使用率并更新峰值
     void sampling_loop() {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Sampling thread started loop.");
+        LOG_DEBUG("[ResourceUtilization::Impl::sampling_loop] Sampling thread started loop.");
+        register_thread_name("res-sampler");
         // 定义采样间隔 (例如，每 20ms 采样一次)
-        const std::chrono::milliseconds sampling_interval(20);
+        const std::chrono::milliseconds sampling_interval(SAMPLING_INTERVAL_MS);
 
-        FILETIME prev_sys_idle, prev_sys_kernel, prev_sys_user;
-        FILETIME prev_proc_creation, prev_proc_exit, prev_proc_kernel, prev_proc_user;
+        unsigned long long prev_sys_total = 0, prev_proc_total = 0;
 
         // 获取初始时间点
-        if (!GetSystemTimes(&prev_sys_idle, &prev_sys_kernel, &prev_sys_user) ||
-            !GetProcessTimes(process_handle_, &prev_proc_creation, &prev_proc_exit, &prev_proc_kernel, &prev_proc_user)) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Error: Initial GetSystemTimes or GetProcessTimes failed in sampling loop.");
+        if (!read_cpu_times(prev_sys_total, prev_proc_total)) {
+            LOG_ERROR("[ResourceUtilization::Impl::sampling_loop] Error: Initial CPU time read failed in sampling loop.");
             return;
         }
 
@@ -330,46 +411,28 @@ public:
             // 等待指定的采样间隔
             std::this_thread::sleep_for(sampling_interval);
 
-            FILETIME sys_idle, sys_kernel, sys_user;
-            FILETIME proc_creation, proc_exit, proc_kernel, proc_user;
+            unsigned long long sys_total = 0, proc_total = 0;
 
             // 获取当前时间点的系统和进程时间
-            if (!GetSystemTimes(&sys_idle, &sys_kernel, &sys_user) ||
-                !GetProcessTimes(process_handle_, &proc_creation, &proc_exit, &proc_kernel, &proc_user)) {
-                Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Error: GetSystemTimes or GetProcessTimes failed during sampling.");
+            if (!read_cpu_times(sys_total, proc_total)) {
+                LOG_ERROR("[ResourceUtilization::Impl::sampling_loop] Error: CPU time read failed during sampling.");
                 continue; // 跳过本次循环，继续下次尝试
             }
 
-            // 将 FILETIME 转换为 64 位整数 (100-nanosecond intervals)
-            ULARGE_INTEGER sys_kernel1, sys_user1, sys_kernel2, sys_user2;
-            ULARGE_INTEGER proc_kernel1, proc_user1, proc_kernel2, proc_user2;
-
-            sys_kernel1.LowPart = prev_sys_kernel.dwLowDateTime; sys_kernel1.HighPart = prev_sys_kernel.dwHighDateTime;
-            sys_user1.LowPart = prev_sys_user.dwLowDateTime; sys_user1.HighPart = prev_sys_user.dwHighDateTime;
-            sys_kernel2.LowPart = sys_kernel.dwLowDateTime; sys_kernel2.HighPart = sys_kernel.dwHighDateTime;
-            sys_user2.LowPart = sys_user.dwLowDateTime; sys_user2.HighPart = sys_user.dwHighDateTime;
-
-            proc_kernel1.LowPart = prev_proc_kernel.dwLowDateTime; proc_kernel1.HighPart = prev_proc_kernel.dwHighDateTime;
-            proc_user1.LowPart = prev_proc_user.dwLowDateTime; proc_user1.HighPart = prev_proc_user.dwHighDateTime;
-            proc_kernel2.LowPart = proc_kernel.dwLowDateTime; proc_kernel2.HighPart = proc_kernel.dwHighDateTime;
-            proc_user2.LowPart = proc_user.dwLowDateTime; proc_user2.HighPart = proc_user.dwHighDateTime;
-
             // 计算系统和进程的时间差
-            ULONGLONG sys_kernel_delta = sys_kernel2.QuadPart - sys_kernel1.QuadPart;
-            ULONGLONG sys_user_delta = sys_user2.QuadPart - sys_user1.QuadPart;
-            ULONGLONG sys_total_delta = sys_kernel_delta + sys_user_delta;
+            const unsigned long long sys_total_delta = sys_total - prev_sys_total;
+            const unsigned long long proc_total_delta = proc_total >= prev_proc_total ? proc_total - prev_proc_total : 0;
 
-            ULONGLONG proc_kernel_delta = proc_kernel2.QuadPart - proc_kernel1.QuadPart;
-            ULONGLONG proc_user_delta = proc_user2.QuadPart - proc_user1.QuadPart;
-            ULONGLONG proc_total_delta = proc_kernel_delta + proc_user_delta;
+            // Linux 的 /proc 计数以时钟节拍（通常 10ms）为单位，20ms 间隔内只有寥寥几个节拍，
+            // 取整误差会使比值失真；节拍不足时保留上一次的基准，累积到足够长的窗口再计算
+            if (sys_total_delta < MIN_SYS_TOTAL_DELTA) {
+                continue;
+            }
 
             // 计算 CPU 使用率百分比
-            double cpu_usage = 0.0;
-            if (sys_total_delta != 0) {
-                cpu_usage = (static_cast<double>(proc_total_delta) / static_cast<double>(sys_total_delta)) * 100.0;
-            }
-            // 确保结果非负
-            if (cpu_usage < 0.0) cpu_usage = 0.0;
+            double cpu_usage = (static_cast<double>(proc_total_delta) / static_cast<double>(sys_total_delta)) * 100.0;
+            // 确保结果落在 [0, 100]
+            cpu_usage = std::max(0.0, std::min(100.0, cpu_usage));
 
             // --- 原子地更新峰值 ---
             // 使用 std::atomic<double> 的 compare_exchange_weak 来实现无锁更新
@@ -383,39 +446,709 @@ public:
                 //   并将 current_peak 更新为 current_cpu_peak_ 的最新值，然后循环继续尝试。
                 if (current_cpu_peak_.compare_exchange_weak(current_peak, cpu_usage)) {
                     // 成功更新峰值
-                    Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] New peak CPU usage: " + std::to_string(cpu_usage) + "%");
+                    LOG_DEBUG("[ResourceUtilization::Impl::sampling_loop] New peak CPU usage: " + std::to_string(cpu_usage) + "%");
                     break; // 跳出循环
                 }
                 // 如果 compare_exchange_weak 失败，current_peak 会被自动更新为最新的值，然后循环继续尝试
             }
             // --- 更新结束 ---
 
+            // 记录期间写入历史环形缓冲区
+            record_sample(cpu_usage);
+
             // 更新 previous times 供下次迭代使用
-            prev_sys_idle = sys_idle;
-            prev_sys_kernel = sys_kernel;
-            prev_sys_user = sys_user;
-            prev_proc_creation = proc_creation;
-            prev_proc_exit = proc_exit;
-            prev_proc_kernel = proc_kernel;
-            prev_proc_user = proc_user;
+            prev_sys_total = sys_total;
+            prev_proc_total = proc_total;
 
         } // while (!stop_sampling_)
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::sampling_loop] Sampling thread exiting loop.");
+        LOG_DEBUG("[ResourceUtilization::Impl::sampling_loop] Sampling thread exiting loop.");
+    }
+    // --- 新增结束 ---
+
+    static constexpr int SAMPLING_INTERVAL_MS = 20;   // 后台采样间隔
+
+    // 计算一次使用率所需的最小系统总时间增量（单位同 read_cpu_times）
+#ifdef _WIN32
+    static constexpr unsigned long long MIN_SYS_TOTAL_DELTA = 1;
+#else
+    static constexpr unsigned long long MIN_SYS_TOTAL_DELTA = 20;   // 约 20 个节拍（所有核心之和）
+#endif
+
+    // 读取系统总 CPU 时间与本进程 CPU 时间，两者单位相同即可
+    // Windows：GetSystemTimes 的内核时间已包含空闲时间，系统总时间 = 内核 + 用户，单位 100ns
+    // Linux：/proc/stat 首行各项之和与 /proc/self/stat 的 utime + stime，单位为时钟节拍
+    bool read_cpu_times(unsigned long long& sys_total, unsigned long long& proc_total) const {
+#ifdef _WIN32
+        FILETIME sys_idle, sys_kernel, sys_user;
+        FILETIME proc_creation, proc_exit, proc_kernel, proc_user;
+        if (!GetSystemTimes(&sys_idle, &sys_kernel, &sys_user) ||
+            !GetProcessTimes(process_handle_, &proc_creation, &proc_exit, &proc_kernel, &proc_user)) {
+            return false;
+        }
+        sys_total = filetime_to_u64(sys_kernel) + filetime_to_u64(sys_user);
+        proc_total = filetime_to_u64(proc_kernel) + filetime_to_u64(proc_user);
+        return true;
+#else
+        std::vector<CpuLineTimes> lines;
+        if (!read_proc_stat(lines, true) || lines.empty() || lines[0].core_id >= 0) {
+            return false;
+        }
+        sys_total = lines[0].total;
+
+        std::ifstream stat_file("/proc/self/stat");
+        std::string content;
+        return std::getline(stat_file, content) && parse_stat_cpu_ticks(content, proc_total);
+#endif
+    }
+
+#ifdef _WIN32
+    static unsigned long long filetime_to_u64(const FILETIME& ft) {
+        ULARGE_INTEGER value;
+        value.LowPart = ft.dwLowDateTime;
+        value.HighPart = ft.dwHighDateTime;
+        return value.QuadPart;
+    }
+#else
+    // /proc/stat 中一行 "cpu" / "cpuN" 的节拍计数
+    struct CpuLineTimes {
+        int core_id = -1;                 // -1 表示汇总行 "cpu"
+        unsigned long long total = 0;     // user + nice + system + idle + iowait + irq + softirq + steal
+        unsigned long long idle = 0;      // idle + iowait
+    };
+
+    // 读取 /proc/stat 的 cpu 行；aggregate_only 为 true 时只读首行
+    static bool read_proc_stat(std::vector<CpuLineTimes>& out, bool aggregate_only = false) {
+        std::ifstream stat_file("/proc/stat");
+        if (!stat_file.is_open()) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(stat_file, line)) {
+            if (line.compare(0, 3, "cpu") != 0) {
+                break; // cpu 行总在文件开头
+            }
+            std::istringstream iss(line);
+            std::string name;
+            iss >> name;
+
+            CpuLineTimes times;
+            if (name.size() > 3) {
+                times.core_id = std::atoi(name.c_str() + 3);
+            }
+            unsigned long long value = 0;
+            for (int i = 0; i < 8 && (iss >> value); ++i) {
+                times.total += value;           // guest/guest_nice 已计入 user/nice，不重复累加
+                if (i == 3 || i == 4) times.idle += value;
+            }
+            out.push_back(times);
+            if (aggregate_only) {
+                break;
+            }
+        }
+        return !out.empty();
+    }
+
+    // 解析 /proc/<pid>/stat 或 /proc/self/task/<tid>/stat 的 utime + stime（时钟节拍）
+    // 第 2 列进程名可能含空格和括号，从最后一个 ')' 之后开始按空格切分：
+    // 其后第 1 项为第 3 列 state，utime/stime 为第 14/15 列
+    static bool parse_stat_cpu_ticks(const std::string& content, unsigned long long& ticks) {
+        const size_t close = content.rfind(')');
+        if (close == std::string::npos) {
+            return false;
+        }
+        std::istringstream iss(content.substr(close + 1));
+        std::string field;
+        unsigned long long utime = 0, stime = 0;
+        int column = 3;
+        for (; column <= 15 && (iss >> field); ++column) {
+            if (column == 14) utime = std::strtoull(field.c_str(), nullptr, 10);
+            if (column == 15) stime = std::strtoull(field.c_str(), nullptr, 10);
+        }
+        ticks = utime + stime;
+        return column > 15;
+    }
+
+    // 两次 /proc/stat 之间单个核心的使用率；间隔过短节拍计数尚未变化时为 0
+    static double core_usage_percent(const CpuLineTimes& prev, const CpuLineTimes& cur) {
+        if (cur.total <= prev.total) {
+            return 0.0;
+        }
+        const double total_delta = static_cast<double>(cur.total - prev.total);
+        const double idle_delta = static_cast<double>(cur.idle >= prev.idle ? cur.idle - prev.idle : 0);
+        return std::max(0.0, std::min(100.0, (1.0 - idle_delta / total_delta) * 100.0));
+    }
+
+    // 读取 /proc/self/status 或 smaps_rollup 中 "Key:  value kB" 形式的字段
+    static bool read_kb_fields(const char* path, const std::vector<std::string>& keys,
+        std::vector<unsigned long long>& values) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        values.assign(keys.size(), 0);
+        std::string line;
+        while (std::getline(file, line)) {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (line.size() > keys[i].size() && line.compare(0, keys[i].size(), keys[i]) == 0 &&
+                    line[keys[i].size()] == ':') {
+                    values[i] = std::strtoull(line.c_str() + keys[i].size() + 1, nullptr, 10);
+                }
+            }
+        }
+        return true;
+    }
+#endif
+
+    // --- 新增：每线程 CPU 统计 ---
+    // 进程内单个线程的累计 CPU 时间
+    struct ThreadTimes {
+        uint64_t tid = 0;
+        uint64_t cpu_ns = 0;      // 用户 + 内核
+        std::string os_name;      // 系统线程名（Windows 线程描述 / Linux comm），可能为空
+    };
+
+    // 记录期间单个线程的跟踪状态
+    struct ThreadTrack {
+        std::string os_name;
+        uint64_t start_ns = 0;          // 记录开始时的累计 CPU；记录中途创建的线程为 0
+        uint64_t last_ns = 0;
+        uint64_t window_ns = 0;         // 当前占用统计窗口起点的累计 CPU
+        std::chrono::steady_clock::time_point window_start;
+        double peak_percent = 0.0;
+        double first_saturated_ms = -1.0;
+    };
+
+    static uint64_t current_thread_os_id() {
+#ifdef _WIN32
+        return static_cast<uint64_t>(GetCurrentThreadId());
+#else
+        return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+    }
+
+    void register_thread_name(const std::string& name) {
+        std::lock_guard<std::mutex> lock(names_mutex_);
+        thread_names_[current_thread_os_id()] = name;
+    }
+
+#ifndef _WIN32
+    // /proc/<pid>/task/<tid>/schedstat 首字段为纳秒级在 CPU 时间（需内核 CONFIG_SCHED_INFO）
+    static bool has_thread_schedstat() {
+        static const bool available = [] {
+            std::ifstream file("/proc/self/schedstat");
+            unsigned long long run_ns = 0;
+            return static_cast<bool>(file >> run_ns);
+        }();
+        return available;
+    }
+#endif
+
+    // 线程累计 CPU 时间的计数粒度（ns）；0 表示纳秒级
+    static uint64_t thread_cpu_resolution_ns() {
+#ifdef _WIN32
+        // GetThreadTimes 按时钟中断间隔计账（默认 15.625ms）
+        DWORD adjustment = 0, increment = 0;
+        BOOL disabled = FALSE;
+        if (GetSystemTimeAdjustment(&adjustment, &increment, &disabled) && increment > 0) {
+            return static_cast<uint64_t>(increment) * 100;
+        }
+        return 15625000ULL;
+#else
+        if (has_thread_schedstat()) {
+            return 0;
+        }
+        const long ticks_per_second = sysconf(_SC_CLK_TCK);
+        return 1000000000ULL / static_cast<unsigned long long>(ticks_per_second > 0 ? ticks_per_second : 100);
+#endif
+    }
+
+    // 枚举本进程全部线程及其累计 CPU 时间
+    static bool enumerate_threads(std::vector<ThreadTimes>& out) {
+        out.clear();
+#ifdef _WIN32
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        const DWORD pid = GetCurrentProcessId();
+        THREADENTRY32 entry;
+        entry.dwSize = sizeof(entry);
+        for (BOOL ok = Thread32First(snapshot, &entry); ok; ok = Thread32Next(snapshot, &entry)) {
+            if (entry.th32OwnerProcessID != pid) continue;
+            HANDLE thread = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ThreadID);
+            if (!thread) continue;
+            FILETIME creation, exit, kernel, user;
+            if (GetThreadTimes(thread, &creation, &exit, &kernel, &user)) {
+                ThreadTimes times;
+                times.tid = entry.th32ThreadID;
+                times.cpu_ns = (filetime_to_u64(kernel) + filetime_to_u64(user)) * 100;
+                times.os_name = thread_description(thread);
+                out.push_back(std::move(times));
+            }
+            CloseHandle(thread);
+        }
+        CloseHandle(snapshot);
+        return true;
+#else
+        DIR* dir = opendir("/proc/self/task");
+        if (!dir) {
+            return false;
+        }
+        static const long ticks_per_second = sysconf(_SC_CLK_TCK);
+        const bool use_schedstat = has_thread_schedstat();
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+            const std::string task = std::string("/proc/self/task/") + entry->d_name;
+
+            ThreadTimes times;
+            times.tid = std::strtoull(entry->d_name, nullptr, 10);
+            unsigned long long run_ns = 0;
+            std::ifstream schedstat_file;
+            if (use_schedstat) {
+                schedstat_file.open(task + "/schedstat");
+            }
+            if (use_schedstat && (schedstat_file >> run_ns)) {
+                times.cpu_ns = run_ns;
+                std::ifstream comm_file(task + "/comm");
+                std::getline(comm_file, times.os_name);
+            }
+            else {
+                // 无 schedstat 时退回 stat 中的 utime + stime（节拍粒度）
+                std::ifstream stat_file(task + "/stat");
+                std::string content;
+                unsigned long long ticks = 0;
+                if (!std::getline(stat_file, content) || !parse_stat_cpu_ticks(content, ticks)) continue;
+                times.cpu_ns = ticks * 1000000000ULL / static_cast<unsigned long long>(ticks_per_second > 0 ? ticks_per_second : 100);
+                const size_t open = content.find('(');
+                const size_t close = content.rfind(')');
+                if (open != std::string::npos && close != std::string::npos && open < close) {
+                    times.os_name = content.substr(open + 1, close - open - 1);
+                }
+            }
+            out.push_back(std::move(times));
+        }
+        closedir(dir);
+        return true;
+#endif
+    }
+
+#ifdef _WIN32
+    // Windows 10 1607+ 的线程描述；旧系统上 kernel32 没有该函数，返回空串
+    static std::string thread_description(HANDLE thread) {
+        using GetThreadDescriptionFn = HRESULT(WINAPI*)(HANDLE, PWSTR*);
+        static const GetThreadDescriptionFn get_description = reinterpret_cast<GetThreadDescriptionFn>(
+            GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "GetThreadDescription"));
+        std::string name;
+        PWSTR description = nullptr;
+        if (get_description && SUCCEEDED(get_description(thread, &description)) && description) {
+            name = wstring_to_string(description);
+            LocalFree(description);
+        }
+        return name;
+    }
+#endif
+
+    // 记录开始：建立各线程的 CPU 基线；调用方持有 record_mutex_
+    void start_thread_tracking() {
+        thread_tracks_.clear();
+        // 节拍粒度的计数单次误差可达一个节拍，窗口至少累积 THREAD_MIN_WINDOW_TICKS 个节拍
+        const uint64_t resolution_ns = thread_cpu_resolution_ns();
+        thread_window_ms_ = std::max(
+            static_cast<double>(ResourceUtilization::THREAD_SAMPLE_INTERVAL_MS),
+            static_cast<double>(resolution_ns) / 1e6 * ResourceUtilization::THREAD_MIN_WINDOW_TICKS);
+        enumerate_threads(thread_scratch_);
+        for (const auto& times : thread_scratch_) {
+            ThreadTrack& track = thread_tracks_[times.tid];
+            track.os_name = times.os_name;
+            track.start_ns = times.cpu_ns;
+            track.last_ns = times.cpu_ns;
+            track.window_ns = times.cpu_ns;
+            track.window_start = record_start_;
+        }
+        last_thread_sample_ = record_start_;
+    }
+
+    // 一次线程采样：更新累计 CPU；窗口累积满 thread_window_ms_ 后计算区间占用、峰值与首次饱和时刻。
+    // 调用方持有 record_mutex_
+    void sample_threads(std::chrono::steady_clock::time_point now) {
+        if (now <= last_thread_sample_ || !enumerate_threads(thread_scratch_)) {
+            return;
+        }
+        const double since_start_ms = std::chrono::duration<double, std::milli>(now - record_start_).count();
+        for (const auto& times : thread_scratch_) {
+            auto it = thread_tracks_.find(times.tid);
+            if (it == thread_tracks_.end()) {
+                // 记录中途创建的线程：CPU 全部计入本轮，区间占用从本次采样开始计算
+                ThreadTrack& track = thread_tracks_[times.tid];
+                track.os_name = times.os_name;
+                track.last_ns = times.cpu_ns;
+                track.window_ns = times.cpu_ns;
+                track.window_start = now;
+                continue;
+            }
+            ThreadTrack& track = it->second;
+            track.last_ns = std::max(track.last_ns, times.cpu_ns);
+            if (!times.os_name.empty()) track.os_name = times.os_name;
+
+            const double window_ms = std::chrono::duration<double, std::milli>(now - track.window_start).count();
+            if (window_ms < thread_window_ms_) {
+                continue;
+            }
+            const uint64_t delta_ns = track.last_ns - track.window_ns;
+            const double percent = std::min(100.0, static_cast<double>(delta_ns) / 1e6 / window_ms * 100.0);
+            track.peak_percent = std::max(track.peak_percent, percent);
+            if (percent >= ResourceUtilization::THREAD_SATURATION_PERCENT && track.first_saturated_ms < 0.0) {
+                track.first_saturated_ms = since_start_ms;
+            }
+            track.window_ns = track.last_ns;
+            track.window_start = now;
+        }
+        last_thread_sample_ = now;
+    }
+
+    // 记录结束：汇总为报告顺序（最先饱和的在前，其余按 CPU 时间降序）；调用方持有 record_mutex_
+    std::vector<ThreadCpuUsage> finish_thread_tracking(double duration_ms) {
+        std::vector<ThreadCpuUsage> usages;
+        std::unordered_map<uint64_t, std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(names_mutex_);
+            names = thread_names_;
+        }
+        for (const auto& entry : thread_tracks_) {
+            const ThreadTrack& track = entry.second;
+            ThreadCpuUsage usage;
+            usage.tid = entry.first;
+            auto name = names.find(entry.first);
+            usage.name = name != names.end() ? name->second : track.os_name;
+            usage.cpu_ms = static_cast<double>(track.last_ns >= track.start_ns ? track.last_ns - track.start_ns : 0) / 1e6;
+            usage.avg_percent = duration_ms > 0.0 ? usage.cpu_ms / duration_ms * 100.0 : 0.0;
+            usage.peak_percent = track.peak_percent;
+            usage.first_saturated_ms = track.first_saturated_ms;
+            usages.push_back(std::move(usage));
+        }
+        std::sort(usages.begin(), usages.end(), [](const ThreadCpuUsage& a, const ThreadCpuUsage& b) {
+            const bool a_sat = a.first_saturated_ms >= 0.0;
+            const bool b_sat = b.first_saturated_ms >= 0.0;
+            if (a_sat != b_sat) return a_sat;
+            if (a_sat && a.first_saturated_ms != b.first_saturated_ms) return a.first_saturated_ms < b.first_saturated_ms;
+            return a.cpu_ms > b.cpu_ms;
+        });
+        thread_tracks_.clear();
+        return usages;
+    }
+    // --- 新增结束 ---
+
+    // --- 新增：资源时间序列 ---
+    // 读取一次进程内存与累计缺页数（比 collect_system_memory_info 轻量，供采样线程周期调用）
+    bool read_process_memory(uint64_t& working_set_kb, uint64_t& private_kb, uint64_t& page_faults) const {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS_EX pmc_ex = { 0 };
+        pmc_ex.cb = sizeof(pmc_ex);
+        if (!process_handle_ ||
+            !GetProcessMemoryInfo(process_handle_, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc_ex), sizeof(pmc_ex))) {
+            return false;
+        }
+        working_set_kb = pmc_ex.WorkingSetSize / 1024;
+        private_kb = pmc_ex.PrivateUsage / 1024;
+        page_faults = pmc_ex.PageFaultCount;
+        return true;
+#else
+        std::vector<unsigned long long> status;
+        if (!read_kb_fields("/proc/self/status", { "VmRSS", "RssAnon", "VmSwap" }, status)) {
+            return false;
+        }
+        working_set_kb = status[0];
+        private_kb = status[1] + status[2];
+        struct rusage usage {};
+        page_faults = getrusage(RUSAGE_SELF, &usage) == 0
+            ? static_cast<uint64_t>(usage.ru_minflt) + static_cast<uint64_t>(usage.ru_majflt) : 0;
+        return true;
+#endif
+    }
+
+    // 写入一个资源采样点，满时覆盖最早的样本；调用方持有 record_mutex_
+    void sample_resources(std::chrono::steady_clock::time_point now) {
+        const size_t capacity = ResourceUtilization::RESOURCE_SERIES_CAPACITY;
+        const size_t index = resource_next_;
+        uint64_t working_set_kb = 0, private_kb = 0, page_faults = 0;
+        read_process_memory(working_set_kb, private_kb, page_faults);
+
+        resource_ring_.t_ms[index] = std::chrono::duration<double, std::milli>(now - record_start_).count();
+        resource_ring_.cpu_percent[index] = resource_cpu_max_;
+        resource_ring_.working_set_kb[index] = working_set_kb;
+        resource_ring_.private_kb[index] = private_kb;
+        resource_ring_.pool_current_kb[index] = GloMemPool::getStats().total_allocated / 1024;
+        resource_ring_.page_faults[index] = page_faults;
+        const NetCounters net = NetMetrics::collect(net_interface_);
+        resource_ring_.net_rx_bytes[index] = net.rx_bytes;
+        resource_ring_.net_tx_bytes[index] = net.tx_bytes;
+        resource_ring_.net_rx_dropped[index] = net.rx_dropped;
+        resource_ring_.udp_rcvbuf_errors[index] = net.udp_rcvbuf_errors;
+        resource_cpu_max_ = -1.0f;
+
+        resource_next_ = (resource_next_ + 1) % capacity;
+        if (resource_count_ < capacity) {
+            ++resource_count_;
+        }
+        else {
+            ++resource_ring_.overwritten;
+        }
+        last_resource_sample_ = now;
+    }
+
+    // 按时间顺序导出资源序列；调用方持有 record_mutex_
+    ResourceSeries export_resources() const {
+        ResourceSeries series;
+        series.start_steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            record_start_.time_since_epoch()).count();
+        series.interval_ms = static_cast<double>(ResourceUtilization::RESOURCE_SAMPLE_INTERVAL_MS);
+        series.overwritten = resource_ring_.overwritten;
+
+        const size_t capacity = ResourceUtilization::RESOURCE_SERIES_CAPACITY;
+        const size_t first = resource_count_ < capacity ? 0 : resource_next_;
+        auto copy_column = [&](const auto& ring, auto& column) {
+            column.reserve(resource_count_);
+            for (size_t i = 0; i < resource_count_; ++i) {
+                column.push_back(ring[(first + i) % capacity]);
+            }
+        };
+        copy_column(resource_ring_.t_ms, series.t_ms);
+        copy_column(resource_ring_.cpu_percent, series.cpu_percent);
+        copy_column(resource_ring_.working_set_kb, series.working_set_kb);
+        copy_column(resource_ring_.private_kb, series.private_kb);
+        copy_column(resource_ring_.pool_current_kb, series.pool_current_kb);
+        copy_column(resource_ring_.page_faults, series.page_faults);
+        copy_column(resource_ring_.net_rx_bytes, series.net_rx_bytes);
+        copy_column(resource_ring_.net_tx_bytes, series.net_tx_bytes);
+        copy_column(resource_ring_.net_rx_dropped, series.net_rx_dropped);
+        copy_column(resource_ring_.udp_rcvbuf_errors, series.udp_rcvbuf_errors);
+        return series;
+    }
+
+    void set_network_interface(const std::string& name) {
+        std::lock_guard<std::mutex> lock(record_mutex_);
+        net_interface_ = name;
+    }
+
+    std::string network_interface() {
+        std::lock_guard<std::mutex> lock(record_mutex_);
+        return net_interface_;
+    }
+
+    ResourceSeries take_resource_series() {
+        std::lock_guard<std::mutex> lock(record_mutex_);
+        ResourceSeries series = std::move(last_resource_series_);
+        last_resource_series_ = ResourceSeries{};
+        return series;
+    }
+    // --- 新增结束 ---
+
+    // --- 新增：CPU 历史记录 ---
+    // 开始记录：复用（首次分配）环形缓冲区，并建立每核数据的基线
+    void start_recording_internal() {
+        if (!is_initialized_) {
+            LOG_WARN("[ResourceUtilization::Impl::start_recording_internal] Warning: Not initialized, CPU history will be empty.");
+            return;
+        }
+        std::lock_guard<std::mutex> lock(record_mutex_);
+        close_record_per_core();
+        record_cores_ = open_record_per_core();
+
+        record_samples_.resize(ResourceUtilization::CPU_HISTORY_CAPACITY);
+        record_per_core_.assign(ResourceUtilization::CPU_HISTORY_CAPACITY * record_cores_, -1.0f);
+        record_next_ = 0;
+        record_count_ = 0;
+        record_overwritten_ = 0;
+        record_start_ = std::chrono::steady_clock::now();
+        start_thread_tracking();
+
+        const size_t resource_capacity = ResourceUtilization::RESOURCE_SERIES_CAPACITY;
+        resource_ring_.t_ms.resize(resource_capacity);
+        resource_ring_.cpu_percent.resize(resource_capacity);
+        resource_ring_.working_set_kb.resize(resource_capacity);
+        resource_ring_.private_kb.resize(resource_capacity);
+        resource_ring_.pool_current_kb.resize(resource_capacity);
+        resource_ring_.page_faults.resize(resource_capacity);
+        resource_ring_.net_rx_bytes.resize(resource_capacity);
+        resource_ring_.net_tx_bytes.resize(resource_capacity);
+        resource_ring_.net_rx_dropped.resize(resource_capacity);
+        resource_ring_.udp_rcvbuf_errors.resize(resource_capacity);
+        resource_ring_.overwritten = 0;
+        resource_next_ = 0;
+        resource_count_ = 0;
+        resource_cpu_max_ = -1.0f;
+        last_resource_sample_ = record_start_;
+        last_resource_series_ = ResourceSeries{};
+        recording_.store(true, std::memory_order_release);
+        LOG_DEBUG("[ResourceUtilization::Impl::start_recording_internal] CPU recording started, cores: " + std::to_string(record_cores_));
+    }
+
+    // 停止记录并按时间顺序导出；缓冲区保留给下一轮复用
+    CpuHistory stop_recording_internal() {
+        CpuHistory history;
+        std::lock_guard<std::mutex> lock(record_mutex_);
+        if (!recording_.exchange(false, std::memory_order_acq_rel)) {
+            return history;
+        }
+        history.start_steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            record_start_.time_since_epoch()).count();
+        history.interval_ms = static_cast<double>(SAMPLING_INTERVAL_MS);
+        history.core_count = record_cores_;
+        history.overwritten = record_overwritten_;
+
+        const auto now = std::chrono::steady_clock::now();
+        history.duration_ms = std::chrono::duration<double, std::milli>(now - record_start_).count();
+        sample_threads(now);
+        history.threads = finish_thread_tracking(history.duration_ms);
+        sample_resources(now);
+        last_resource_series_ = export_resources();
+
+        const size_t capacity = record_samples_.size();
+        const size_t first = record_count_ < capacity ? 0 : record_next_;
+        history.samples.reserve(record_count_);
+        history.per_core.reserve(record_count_ * record_cores_);
+        for (size_t i = 0; i < record_count_; ++i) {
+            const size_t index = (first + i) % capacity;
+            history.samples.push_back(record_samples_[index]);
+            const float* cores = record_per_core_.data() + index * record_cores_;
+            history.per_core.insert(history.per_core.end(), cores, cores + record_cores_);
+        }
+        close_record_per_core();
+        LOG_DEBUG("[ResourceUtilization::Impl::stop_recording_internal] CPU recording stopped, samples: " + std::to_string(history.samples.size()));
+        return history;
+    }
+
+    // 由采样线程调用：写入一个采样点，满时覆盖最早的样本
+    void record_sample(double process_percent) {
+        if (!recording_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(record_mutex_);
+        if (!recording_.load(std::memory_order_relaxed) || record_samples_.empty()) {
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        const size_t index = record_next_;
+        CpuSample& sample = record_samples_[index];
+        sample.t_ms = std::chrono::duration<double, std::milli>(now - record_start_).count();
+        sample.process_percent = static_cast<float>(process_percent);
+        if (record_cores_ > 0) {
+            sample_record_per_core(record_per_core_.data() + index * record_cores_);
+        }
+
+        record_next_ = (record_next_ + 1) % record_samples_.size();
+        if (record_count_ < record_samples_.size()) {
+            ++record_count_;
+        }
+        else {
+            ++record_overwritten_;
+        }
+
+        resource_cpu_max_ = std::max(resource_cpu_max_, sample.process_percent);
+        if (now - last_resource_sample_ >= std::chrono::milliseconds(ResourceUtilization::RESOURCE_SAMPLE_INTERVAL_MS)) {
+            sample_resources(now);
+        }
+
+        // 线程枚举开销较大，按更长的间隔进行
+        if (now - last_thread_sample_ >= std::chrono::milliseconds(ResourceUtilization::THREAD_SAMPLE_INTERVAL_MS)) {
+            sample_threads(now);
+        }
+    }
+
+    // 记录专用的每核数据源（与 getPerCoreUsageSnapshot 的查询相互独立，避免两个线程交错取差值）
+    // 返回核心数，0 表示不采集每核数据；调用方持有 record_mutex_
+    uint32_t open_record_per_core() {
+#ifdef _WIN32
+        if (PdhOpenQuery(NULL, 0, &record_query_) != ERROR_SUCCESS) {
+            record_query_ = nullptr;
+            return 0;
+        }
+        SYSTEM_INFO sysInfo;
+        GetSystemInfo(&sysInfo);
+        for (DWORD i = 0; i < sysInfo.dwNumberOfProcessors; ++i) {
+            std::wstring path = L"\\Processor(" + std::to_wstring(i) + L")\\% Processor Time";
+            PDH_HCOUNTER counter;
+            if (PdhAddCounter(record_query_, path.c_str(), 0, &counter) != ERROR_SUCCESS) {
+                break; // 核心编号连续，某个失败后其余也无法对应
+            }
+            record_counters_.push_back(counter);
+        }
+        if (record_counters_.empty()) {
+            PdhCloseQuery(record_query_);
+            record_query_ = nullptr;
+            return 0;
+        }
+        PdhCollectQueryData(record_query_); // 基线
+        return static_cast<uint32_t>(record_counters_.size());
+#else
+        std::vector<CpuLineTimes> lines;
+        if (!read_proc_stat(lines)) {
+            return 0;
+        }
+        for (const auto& line : lines) {
+            if (line.core_id >= 0) record_prev_cores_.push_back(line);
+        }
+        return static_cast<uint32_t>(record_prev_cores_.size());
+#endif
+    }
+
+    void close_record_per_core() {
+#ifdef _WIN32
+        if (record_query_) {
+            PdhCloseQuery(record_query_);
+            record_query_ = nullptr;
+        }
+        record_counters_.clear();
+#else
+        record_prev_cores_.clear();
+#endif
+        record_cores_ = 0;
+    }
+
+    // 采集一次各核心使用率写入 out[0, record_cores_)；失败的核心保持 -1
+    void sample_record_per_core(float* out) {
+        std::fill(out, out + record_cores_, -1.0f);
+#ifdef _WIN32
+        if (!record_query_ || PdhCollectQueryData(record_query_) != ERROR_SUCCESS) {
+            return;
+        }
+        for (size_t i = 0; i < record_counters_.size() && i < record_cores_; ++i) {
+            PDH_FMT_COUNTERVALUE value;
+            if (PdhGetFormattedCounterValue(record_counters_[i], PDH_FMT_DOUBLE, NULL, &value) == ERROR_SUCCESS) {
+                out[i] = static_cast<float>(value.doubleValue);
+            }
+        }
+#else
+        std::vector<CpuLineTimes> lines;
+        if (!read_proc_stat(lines)) {
+            return;
+        }
+        size_t slot = 0;
+        for (const auto& line : lines) {
+            if (line.core_id < 0) continue;
+            if (slot >= record_prev_cores_.size() || slot >= record_cores_) break;
+            if (record_prev_cores_[slot].core_id == line.core_id) {
+                out[slot] = static_cast<float>(core_usage_percent(record_prev_cores_[slot], line));
+                record_prev_cores_[slot] = line;
+            }
+            ++slot;
+        }
+#endif
     }
     // --- 新增结束 ---
 
     // --- 修改：get_cpu_peak_since_last_call 现在只返回并重置峰值 ---
     // 这个函数由 collectCurrentMetrics 调用，获取并重置由后台线程维护的峰值
     double get_cpu_peak_since_last_call() {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Called.");
+        LOG_DEBUG("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Called.");
         if (!is_initialized_) {
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Error: Not initialized.");
+            LOG_ERROR("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Error: Not initialized.");
             return -1.0;
         }
         // 原子地加载当前峰值，并将其重置为 -1.0 (表示下一轮监控周期的开始)
         // exchange 操作是原子的：它返回旧值，并将新值存入 atomic 变量
         double peak = current_cpu_peak_.exchange(-1.0);
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Returning peak: " + std::to_string(peak) + "% and resetting internal peak tracker.");
+        LOG_DEBUG("[ResourceUtilization::Impl::get_cpu_peak_since_last_call] Returning peak: " + std::to_string(peak) + "% and resetting internal peak tracker.");
         return peak;
     }
     // --- 修改结束 ---
@@ -424,6 +1157,7 @@ public:
     void collect_system_memory_info(SysMetrics& metrics_out) const;
     // --- 新增结束 ---
 
+#ifdef _WIN32
     // --- 新增：辅助函数：安全地将 std::wstring 转换为 std::string ---
     // 解决 C4244 警告
     static std::string wstring_to_string(const std::wstring& wstr) {
@@ -435,6 +1169,7 @@ public:
         return str;
     }
     // --- 新增结束 ---
+#endif
 
 private:
     // --- 成员变量 ---
@@ -449,11 +1184,48 @@ private:
     std::atomic<bool> stop_sampling_; // 停止采样的标志
     std::atomic<double> current_cpu_peak_; // 存储当前采样周期内的 CPU 使用率峰值
 
+    // CPU 历史记录（环形缓冲区，由 record_mutex_ 保护；recording_ 供采样线程无锁快速判断）
+    std::mutex record_mutex_;
+    std::atomic<bool> recording_{ false };
+    std::vector<CpuSample> record_samples_;
+    std::vector<float> record_per_core_;
+    uint32_t record_cores_ = 0;
+    size_t record_next_ = 0;
+    size_t record_count_ = 0;
+    uint64_t record_overwritten_ = 0;
+    std::chrono::steady_clock::time_point record_start_;
+    // 每线程 CPU 统计（由 record_mutex_ 保护）
+    std::unordered_map<uint64_t, ThreadTrack> thread_tracks_;
+    std::vector<ThreadTimes> thread_scratch_;
+    double thread_window_ms_ = ResourceUtilization::THREAD_SAMPLE_INTERVAL_MS;
+    std::chrono::steady_clock::time_point last_thread_sample_;
+    // 资源时间序列（列式环形缓冲区，由 record_mutex_ 保护）
+    ResourceSeries resource_ring_;
+    size_t resource_next_ = 0;
+    size_t resource_count_ = 0;
+    float resource_cpu_max_ = -1.0f;    // 当前资源采样区间内 CPU 采样点的最大值
+    std::chrono::steady_clock::time_point last_resource_sample_;
+    ResourceSeries last_resource_series_;  // 最近一次停止记录时导出，等待 take_resource_series 取走
+    std::string net_interface_;         // 网络计数统计的网卡，空表示全部 up 状态的物理网卡（由 record_mutex_ 保护）
+    // registerCurrentThread 登记的线程名
+    std::mutex names_mutex_;
+    std::unordered_map<uint64_t, std::string> thread_names_;
+#ifdef _WIN32
+    PDH_HQUERY record_query_ = nullptr;
+    std::vector<PDH_HCOUNTER> record_counters_;
+#else
+    std::vector<CpuLineTimes> record_prev_cores_;
+#endif
+
     // --- 新增：每个核心监控相关 ---
 #ifdef _WIN32
     mutable PDH_HQUERY query_; // PDH 查询句柄
     mutable std::vector<PDH_HCOUNTER> counters_; // PDH 计数器句柄列表
     mutable std::vector<std::wstring> counterPaths_; // 存储每个核心的计数器路径 (wstring)
+#else
+    bool per_core_ready_ = false;                        // /proc/stat 基线是否已建立
+    mutable std::vector<CpuLineTimes> prev_core_times_;  // 上一次快照的各核心节拍计数
+    mutable unsigned long long peak_private_kb_ = 0;     // 观测到的私有内存峰值（Linux 无 PeakPagefileUsage）
 #endif
     // --- 新增结束 ---
     // --- 成员变量结束 ---
@@ -481,32 +1253,32 @@ ResourceUtilization::~ResourceUtilization() {
 
 // 公共初始化接口
 bool ResourceUtilization::initialize() {
-    Logger::getInstance().logAndPrint("[ResourceUtilization::initialize] Requested initialization.");
+    LOG_DEBUG("[ResourceUtilization::initialize] Requested initialization.");
     bool ok = pimpl_->initialize_internal();
     if (ok) {
         is_initialized_ = true;
-        Logger::getInstance().logAndPrint("[ResourceUtilization::initialize] Initialization successful.");
+        LOG_INFO("[ResourceUtilization::initialize] Initialization successful.");
     }
     else {
         is_initialized_ = false;
-        Logger::getInstance().logAndPrint("[ResourceUtilization::initialize] Initialization failed.");
+        LOG_ERROR("[ResourceUtilization::initialize] Initialization failed.");
     }
     return ok;
 }
 
 // 公共关闭接口
 void ResourceUtilization::shutdown() {
-    Logger::getInstance().logAndPrint("[ResourceUtilization::shutdown] Requested shutdown.");
+    LOG_DEBUG("[ResourceUtilization::shutdown] Requested shutdown.");
     if (pimpl_) {
         pimpl_->shutdown_internal();
     }
     is_initialized_ = false;
-    Logger::getInstance().logAndPrint("[ResourceUtilization::shutdown] Shutdown process completed.");
+    LOG_DEBUG("[ResourceUtilization::shutdown] Shutdown process completed.");
 }
 
 // 【核心】采集当前系统指标
 SysMetrics ResourceUtilization::collectCurrentMetrics() const {
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] Collecting metrics...");
+    LOG_DEBUG("[ResourceUtilization::collectCurrentMetrics] Collecting metrics...");
     SysMetrics metrics{};
 
     // 初始化所有指标为默认值 (包括新增的系统级指标)
@@ -532,31 +1304,37 @@ SysMetrics ResourceUtilization::collectCurrentMetrics() const {
     // --- 修改结束 ---
     if (cpu_peak >= 0.0) {
         metrics.cpu_usage_percent_peak = cpu_peak;
-        Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] CPU usage peak (valid): " + std::to_string(cpu_peak));
+        LOG_DEBUG("[ResourceUtilization::collectCurrentMetrics] CPU usage peak (valid): " + std::to_string(cpu_peak));
     }
     else if (cpu_peak == -1.0) {
         // 这可能意味着初始化失败，或者在采样周期内没有获取到有效数据 (例如，进程非常空闲)
         metrics.cpu_usage_percent_peak = -1.0;
-        Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] CPU usage peak collection returned -1.0 (no data or error).");
+        LOG_WARN("[ResourceUtilization::collectCurrentMetrics] CPU usage peak collection returned -1.0 (no data or error).");
     }
     // 注意：由于后台线程持续运行，理论上不太可能返回 < -1.0 的值
 
     // 2. 内存统计来自 GloMemPool (保持原有逻辑不变)
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] Collecting memory stats from GloMemPool...");
+    LOG_DEBUG("[ResourceUtilization::collectCurrentMetrics] Collecting memory stats from GloMemPool...");
     auto mem_stats = GloMemPool::getStats();
     metrics.memory_peak_kb = static_cast<unsigned long long>(mem_stats.peak_usage / 1024);
     metrics.memory_current_kb = static_cast<unsigned long long>(mem_stats.total_allocated / 1024);
     metrics.memory_alloc_count = mem_stats.alloc_count;
     metrics.memory_dealloc_count = mem_stats.dealloc_count;
     metrics.memory_current_blocks = mem_stats.current_blocks;
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] GloMemPool stats collected.");
+    LOG_DEBUG("[ResourceUtilization::collectCurrentMetrics] GloMemPool stats collected.");
 
     // --- 新增：委托给 Impl 收集系统级进程内存信息 ---
     // 通过 Impl 的私有方法安全地访问其成员并收集系统内存信息
     pimpl_->collect_system_memory_info(metrics);
     // --- 新增结束 ---
 
-    Logger::getInstance().logAndPrint("[ResourceUtilization::collectCurrentMetrics] Metrics collection complete.");
+    // 3. 网卡与 UDP/TCP 累计计数
+    metrics.net = NetMetrics::collect(pimpl_->network_interface());
+    if (!metrics.net.available) {
+        LOG_DEBUG("[ResourceUtilization::collectCurrentMetrics] Network interface counters unavailable.");
+    }
+
+    LOG_DEBUG("[ResourceUtilization::collectCurrentMetrics] Metrics collection complete.");
     return metrics;
 }
 
@@ -564,7 +1342,7 @@ SysMetrics ResourceUtilization::collectCurrentMetrics() const {
 // --- 新增：公共接口实现 ---
 bool ResourceUtilization::initializePerCoreMonitoring() {
     if (!is_initialized_ || !pimpl_) {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::initializePerCoreMonitoring] Error: Main resource utilization not initialized.");
+        LOG_ERROR("[ResourceUtilization::initializePerCoreMonitoring] Error: Main resource utilization not initialized.");
         return false;
     }
     // 委托给 Impl 的内部初始化方法
@@ -580,7 +1358,7 @@ void ResourceUtilization::shutdownPerCoreMonitoring() {
 
 std::vector<PerCoreUsage> ResourceUtilization::getPerCoreUsageSnapshot() const {
     if (!is_initialized_ || !pimpl_) {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::getPerCoreUsageSnapshot] Error: ResourceUtilization not initialized.");
+        LOG_ERROR("[ResourceUtilization::getPerCoreUsageSnapshot] Error: ResourceUtilization not initialized.");
         return {}; // Return empty vector if not initialized
     }
     // 委托给 Impl 的内部获取快照方法
@@ -588,24 +1366,47 @@ std::vector<PerCoreUsage> ResourceUtilization::getPerCoreUsageSnapshot() const {
 }
 // --- 新增结束 ---
 
-// --- 其他现有方法 (start_cpu_recording, stop_cpu_recording_and_get_history) 的实现 ---
-// (请将您原有的实现放在这里，并确保 stop_cpu_recording_and_get_history 有 return 语句)
+// --- CPU 历史记录 ---
 void ResourceUtilization::start_cpu_recording() {
-    // ... (您的现有实现逻辑) ...
-    // TODO: 实现 CPU 记录启动逻辑
-    Logger::getInstance().logAndPrint("[ResourceUtilization::start_cpu_recording] CPU recording started (placeholder).");
+    if (pimpl_) {
+        pimpl_->start_recording_internal();
+    }
 }
 
 std::vector<float> ResourceUtilization::stop_cpu_recording_and_get_history() {
-    // ... (您的现有实现逻辑) ...
-    // 例如：
-    std::vector<float> history;
-    // ... (填充 history 的逻辑) ...
-    // ... (可能的清理逻辑) ...
-    Logger::getInstance().logAndPrint("[ResourceUtilization::stop_cpu_recording_and_get_history] CPU recording stopped and history retrieved (placeholder).");
-    return history; // <--- 确保有 return 语句
-    // 如果暂时没有实现，可以返回空 vector:
-    // return {};
+    const CpuHistory history = stop_cpu_recording_and_get_samples();
+    std::vector<float> values;
+    values.reserve(history.samples.size());
+    for (const auto& sample : history.samples) {
+        values.push_back(sample.process_percent);
+    }
+    return values;
+}
+
+void ResourceUtilization::setNetworkInterface(const std::string& name) {
+    if (pimpl_) {
+        pimpl_->set_network_interface(name);
+    }
+}
+
+ResourceSeries ResourceUtilization::take_resource_series() {
+    if (!pimpl_) {
+        return ResourceSeries{};
+    }
+    return pimpl_->take_resource_series();
+}
+
+void ResourceUtilization::registerCurrentThread(const std::string& name) {
+    if (pimpl_) {
+        pimpl_->register_thread_name(name);
+    }
+}
+
+CpuHistory ResourceUtilization::stop_cpu_recording_and_get_samples() {
+    if (!pimpl_) {
+        return CpuHistory{};
+    }
+    return pimpl_->stop_recording_internal();
 }
 // --- 其他现有方法结束 ---
 
@@ -625,18 +1426,52 @@ void ResourceUtilization::Impl::collect_system_memory_info(SysMetrics& metrics_o
             metrics_out.system_private_usage_kb = pmc_ex.PrivateUsage / 1024;
             metrics_out.system_quota_paged_pool_usage_kb = pmc_ex.QuotaPagedPoolUsage / 1024;
             metrics_out.system_quota_nonpaged_pool_usage_kb = pmc_ex.QuotaNonPagedPoolUsage / 1024;
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collected.");
+            LOG_DEBUG("[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collected.");
         }
         else {
             DWORD error = GetLastError();
-            Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] Error getting process memory info: " + std::to_string(error));
+            LOG_ERROR("[ResourceUtilization::Impl::collect_system_memory_info] Error getting process memory info: " + std::to_string(error));
         }
     }
     else {
-        Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] Warning: Process handle or Impl not initialized for system memory stats.");
+        LOG_WARN("[ResourceUtilization::Impl::collect_system_memory_info] Warning: Process handle or Impl not initialized for system memory stats.");
     }
 #else
-    Logger::getInstance().logAndPrint("[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collection not implemented for non-Windows.");
+    if (!this->is_initialized_) {
+        LOG_WARN("[ResourceUtilization::Impl::collect_system_memory_info] Warning: Impl not initialized for system memory stats.");
+        return;
+    }
+
+    // VmRSS / VmHWM 对应工作集 / 峰值工作集；RssAnon + VmSwap 近似私有提交量
+    std::vector<unsigned long long> status;
+    if (!read_kb_fields("/proc/self/status", { "VmRSS", "VmHWM", "RssAnon", "VmSwap" }, status)) {
+        LOG_ERROR("[ResourceUtilization::Impl::collect_system_memory_info] Error reading /proc/self/status.");
+        return;
+    }
+    metrics_out.system_working_set_kb = status[0];
+    metrics_out.system_peak_working_set_kb = status[1];
+
+    // smaps_rollup（内核 4.14+）给出精确的私有页：Private_Clean + Private_Dirty + Swap
+    unsigned long long private_kb = status[2] + status[3];
+    std::vector<unsigned long long> rollup;
+    if (read_kb_fields("/proc/self/smaps_rollup", { "Private_Clean", "Private_Dirty", "Swap" }, rollup) &&
+        rollup[0] + rollup[1] > 0) {
+        private_kb = rollup[0] + rollup[1] + rollup[2];
+    }
+    metrics_out.system_private_usage_kb = private_kb;
+    metrics_out.system_pagefile_usage_kb = private_kb;    // 与 Windows 一致：提交量按私有内存计
+    peak_private_kb_ = std::max(peak_private_kb_, private_kb);
+    metrics_out.system_peak_pagefile_usage_kb = peak_private_kb_;
+
+    // 旧内核没有 VmHWM 时，用 getrusage 的 ru_maxrss（单位 KB）兜底
+    if (metrics_out.system_peak_working_set_kb == 0) {
+        struct rusage usage {};
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            metrics_out.system_peak_working_set_kb = static_cast<unsigned long long>(usage.ru_maxrss);
+        }
+    }
+    // 分页池 / 非分页池配额为 Windows 特有概念，Linux 下保持 0
+    LOG_DEBUG("[ResourceUtilization::Impl::collect_system_memory_info] System process memory stats collected.");
 #endif
 }
 // --- 新增结束 ---
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "SysMetrics.h" // ȷ SysMetrics.h
 #include <memory>
+#include <string>
 #include <vector>
 
 // ---  PerCoreUsage ͷļ ---
@@ -47,11 +48,39 @@ public:
     SysMetrics collectCurrentMetrics() const;
 
     // --- ڿ CPU ʷ¼ķ ---
-    //  CPU ʹʼ¼
+    //  CPU ʹʼ¼̨̰߳ÿ㣨 + ÿˣдԤĻλ
     void start_cpu_recording();
 
-    // ֹͣ CPU ¼ȡ¼ʷ
+    // ֹͣ CPU ¼ȡ¼ʷݣʹУ
     std::vector<float> stop_cpu_recording_and_get_history();
+
+    // ֹͣ CPU ¼ȡʱÿݵʷ
+    CpuHistory stop_cpu_recording_and_get_samples();
+
+    // λ 20ms Լɸ 5 ӣִα
+    static constexpr size_t CPU_HISTORY_CAPACITY = 16384;
+
+    // ÿ߳ CPU ͳƣ¼ڼÿ THREAD_SAMPLE_INTERVAL_MS öһν߳
+    // Windows: Toolhelp32 + GetThreadTimesLinux: /proc/self/task/*/schedstatȱʧʱ˻ stat
+    //  CpuHistory::threads 
+    static constexpr int THREAD_SAMPLE_INTERVAL_MS = 100;
+    // ΪʱGetThreadTimes Լ 15.6msstat 10msռۻôټ㣨  5%
+    static constexpr int THREAD_MIN_WINDOW_TICKS = 20;
+    static constexpr double THREAD_SATURATION_PERCENT = 90.0;   // ̴߳ﵽռüΪ
+
+    // ԴʱУ¼ڼÿ RESOURCE_SAMPLE_INTERVAL_MS ɼһ CPU /  / GloMemPool / ȱҳ
+    // дԤʽλ100ms * 6000 = 10 ӣ ThroughputSeries Ĭֵһ£
+    static constexpr int RESOURCE_SAMPLE_INTERVAL_MS = 100;
+    static constexpr size_t RESOURCE_SERIES_CAPACITY = 6000;
+
+    // ͳƵLinux: /proc/net/dev еƣWindows: ӿڱձʾȫ up ״̬
+    void setNetworkInterface(const std::string& name);
+
+    // ȡһ stop_cpu_recording_* ԴʱУȡգ
+    ResourceSeries take_resource_series();
+
+    // Ϊǰ̵߳Ǽһɶƣ "send-loop""dds-listener"ʹ
+    void registerCurrentThread(const std::string& name);
     // ---  ---
 
     // --- ȡÿ CPU ʹʵķ () ---
@@ -1,5 +1,34 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <string>
+#include <vector>
+
+// ۼִֵ = end - start NetMetrics ɼ
+struct NetCounters {
+    bool available = false;                 // ȡɹ
+    bool protocol_available = false;        // UDP/TCP Эȡɹ
+    std::string interface_name;             // ͳƵձʾȫ up ״̬֮
+
+    //  (Linux: /proc/net/devWindows: GetIfTable2)
+    unsigned long long rx_bytes = 0;
+    unsigned long long tx_bytes = 0;
+    unsigned long long rx_packets = 0;
+    unsigned long long tx_packets = 0;
+    unsigned long long rx_dropped = 0;
+    unsigned long long tx_dropped = 0;
+    unsigned long long rx_errors = 0;
+    unsigned long long tx_errors = 0;
+
+    // Э (Linux: /proc/net/snmpWindows: GetUdpStatisticsEx / GetTcpStatisticsEx IPv4)
+    unsigned long long udp_in_datagrams = 0;
+    unsigned long long udp_out_datagrams = 0;
+    unsigned long long udp_in_errors = 0;
+    unsigned long long udp_rcvbuf_errors = 0;   // socket ջWindows ޴ udp_in_errors
+    unsigned long long udp_sndbuf_errors = 0;
+    unsigned long long udp_no_ports = 0;
+    unsigned long long tcp_retrans_segs = 0;
+};
 
 // ϵͳԴָṹ
 struct SysMetrics {
@@ -29,4 +58,85 @@ struct SysMetrics {
     unsigned long long system_quota_paged_pool_usage_kb = 0;    // ҳʹ
     unsigned long long system_quota_nonpaged_pool_usage_kb = 0; // Ƿҳʹ
     // ---  ---
+
+    // ۼֵ
+    NetCounters net;
+};
+
+//  CPU 㣨 ResourceUtilization ̨߳ڼ¼ڼд룩
+struct CpuSample {
+    double t_ms = 0.0;              // ¼ʼʱ (ms)
+    float process_percent = 0.0f;   //  CPU ʹʣռȫĵİٷֱȣֵھһ£
+};
+
+// ߳һڵ CPU ռãٷֱȾԵΪ 100%
+struct ThreadCpuUsage {
+    uint64_t tid = 0;                   // ϵͳ߳ ID
+    std::string name;                   // Ǽ > ϵͳ߳ > 
+    double cpu_ms = 0.0;                // ĵ CPU ʱ䣨û + ںˣ
+    double avg_percent = 0.0;           // cpu_ms / ¼ʱ
+    double peak_percent = 0.0;          // ̲߳ڵֵ
+    double first_saturated_ms = -1.0;   // ״δﵽֵʱ̣¼ʼ-1 ʾδ
+};
+
+// һֲԵ CPU ʷʹʱ + ͬһʱ̸ʹ
+struct CpuHistory {
+    int64_t start_steady_ns = 0;        // ¼ʼʱ̣steady_clockʱж
+    double interval_ms = 0.0;           // 
+    uint32_t core_count = 0;            // ÿĺ0 ʾδɼÿ
+    uint64_t overwritten = 0;           // λд󱻸ǵ
+    std::vector<CpuSample> samples;     // ʱ
+    std::vector<float> per_core;        // samples.size() * core_count i ĺ c λ [i * core_count + c]-1 ʾЧ
+    double duration_ms = 0.0;           // ¼ʱ
+    std::vector<ThreadCpuUsage> threads;   // "ȱ͡ CPU ʱ"
+};
+
+// һֲԵԴʱУʽ洢± i ͬһ㣩
+struct ResourceSeries {
+    int64_t start_steady_ns = 0;            // ¼ʼʱ̣steady_clock CpuHistory ͬ
+    double interval_ms = 0.0;               // 
+    uint64_t overwritten = 0;               // λд󱻸ǵ
+    std::vector<double> t_ms;               // ¼ʼʱ (ms)
+    std::vector<float> cpu_percent;         // ڽ CPU ʹʵֵ
+    std::vector<uint64_t> working_set_kb;   //  (Linux: VmRSS)
+    std::vector<uint64_t> private_kb;       // ˽ύ (Linux: RssAnon + VmSwap)
+    std::vector<uint64_t> pool_current_kb;  // GloMemPool ǰ
+    std::vector<uint64_t> page_faults;      // ۼȱҳ (Linux: minflt + majflt)
+    std::vector<uint64_t> net_rx_bytes;     // Ϊۼ NetCounters
+    std::vector<uint64_t> net_tx_bytes;
+    std::vector<uint64_t> net_rx_dropped;
+    std::vector<uint64_t> udp_rcvbuf_errors;
+
+    size_t size() const { return t_ms.size(); }
+};
+
+// һֲе̵߳Ӳܼ PerfCountersΪ -1 ʾδܴ
+struct PerfCounterReport {
+    bool available = false;         // һЧ
+    bool user_only = false;         // ͳû̬ perf_event_paranoid ƣ
+    bool thread_wide = false;       // ̣߳ص֮հ/ȣÿֵΪ̯߳
+    std::string unavailable_reason; // ʧܵļԭ
+    uint64_t samples = 0;           // ڷ / յ
+    double multiplex_ratio = 1.0;   // С time_running / time_enabled< 1 ʾмò
+    double cycles = -1.0;
+    double instructions = -1.0;
+    double llc_misses = -1.0;
+    double branch_misses = -1.0;
+    double context_switches = -1.0;
+    double page_faults = -1.0;
+
+    double perSample(double value) const {
+        return value >= 0.0 && samples > 0 ? value / static_cast<double>(samples) : -1.0;
+    }
+    double ipc() const {
+        return cycles > 0.0 && instructions >= 0.0 ? instructions / cycles : -1.0;
+    }
+};
+
+// CPU ʷĻͳƣٷֱȣsamples Ϊ 0 ʱֵΪ -1
+struct CpuUsageStats {
+    size_t samples = 0;
+    double avg = -1.0;
+    double p95 = -1.0;
+    double peak = -1.0;
 };
\ No newline at end of file
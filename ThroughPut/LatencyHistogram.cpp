@@ -0,0 +1,76 @@
+﻿// LatencyHistogram.cpp
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(BUCKET_COUNT, 0)
+{
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_count_ = 0;
+    sum_ns_ = 0;
+    min_ns_ = UINT64_MAX;
+    max_ns_ = 0;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    total_count_ += other.total_count_;
+    sum_ns_ += other.sum_ns_;
+    min_ns_ = std::min(min_ns_, other.min_ns_);
+    max_ns_ = std::max(max_ns_, other.max_ns_);
+}
+
+uint64_t LatencyHistogram::lowestEquivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const uint64_t shift = index / SUB_BUCKET_HALF - 1;
+    const uint64_t sub = index - shift * SUB_BUCKET_HALF;
+    return sub << shift;
+}
+
+uint64_t LatencyHistogram::bucketWidth(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return 1;
+    }
+    return 1ULL << (index / SUB_BUCKET_HALF - 1);
+}
+
+uint64_t LatencyHistogram::percentileNs(double percentile) const {
+    if (total_count_ == 0) return 0;
+
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    // nearest-rank：第 ceil(p * N) 个样本
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_count_));
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            const uint64_t mid = lowestEquivalent(i) + bucketWidth(i) / 2;
+            return std::min(std::max(mid, min_ns_), max_ns_);
+        }
+    }
+    return max_ns_;
+}
+
+void LatencyHistogram::appendBuckets(std::string& out, char separator) const {
+    bool first = true;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (counts_[i] == 0) continue;
+        if (!first) out += separator;
+        out += std::to_string(lowestEquivalent(i));
+        out += ':';
+        out += std::to_string(counts_[i]);
+        first = false;
+    }
+}
@@ -0,0 +1,74 @@
+﻿// LatencyHistogram.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 固定内存的 log-linear 时延直方图（HDR 风格，单位: ns）
+// - 前 2048 个桶精确到 1ns，其后每翻一倍范围再切 1024 个子桶，相对误差 < 0.1%（约 3 位有效数字）
+// - 可记录范围 [0, 2^36) ns（约 68 秒），超出部分计入最大桶
+// - record() 不分配内存、不加锁：每个实例只允许一个写线程（通常是 Listener 线程），
+//   读取（分位数、合并、序列化）须在写线程停止记录后进行；多线程记录时每线程一个实例，最后 merge()
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 11;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;       // 2048
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;           // 1024
+    static constexpr int MAX_VALUE_BITS = 36;
+    static constexpr uint64_t MAX_TRACKABLE_NS = (1ULL << MAX_VALUE_BITS) - 1;
+    static constexpr size_t BUCKET_COUNT =
+        static_cast<size_t>((MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_HALF + SUB_BUCKET_HALF);
+
+    LatencyHistogram();
+
+    // 记录一个样本（ns），热路径，内联
+    inline void record(uint64_t value_ns) {
+        if (value_ns > MAX_TRACKABLE_NS) value_ns = MAX_TRACKABLE_NS;
+        ++counts_[indexOf(value_ns)];
+        ++total_count_;
+        sum_ns_ += value_ns;
+        if (value_ns < min_ns_) min_ns_ = value_ns;
+        if (value_ns > max_ns_) max_ns_ = value_ns;
+    }
+
+    void reset();
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return total_count_; }
+    bool empty() const { return total_count_ == 0; }
+    uint64_t minNs() const { return total_count_ ? min_ns_ : 0; }
+    uint64_t maxNs() const { return max_ns_; }
+    double meanNs() const { return total_count_ ? static_cast<double>(sum_ns_) / total_count_ : 0.0; }
+
+    // 分位数（percentile 取 0~100），返回所在桶的中点，并裁剪到 [min, max]
+    uint64_t percentileNs(double percentile) const;
+
+    // 非空桶序列化到 out 末尾："bucket_low_ns:count"，以 separator 分隔（桶宽度由 bucketWidth 推出）
+    void appendBuckets(std::string& out, char separator) const;
+
+    static inline size_t indexOf(uint64_t value_ns) {
+        if (value_ns < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value_ns);
+        }
+        const int shift = highestBit(value_ns) - (SUB_BUCKET_BITS - 1);
+        return static_cast<size_t>(shift * SUB_BUCKET_HALF + (value_ns >> shift));
+    }
+
+    static uint64_t lowestEquivalent(size_t index);
+    static uint64_t bucketWidth(size_t index);
+
+private:
+    static inline int highestBit(uint64_t v) {
+        int bit = 0;
+        while (v >>= 1) ++bit;
+        return bit;
+    }
+
+    std::vector<uint64_t> counts_;  // 构造时一次性分配 BUCKET_COUNT 个计数
+    uint64_t total_count_ = 0;
+    uint64_t sum_ns_ = 0;
+    uint64_t min_ns_ = UINT64_MAX;
+    uint64_t max_ns_ = 0;
+};
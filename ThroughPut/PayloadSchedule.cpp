@@ -0,0 +1,131 @@
+﻿// PayloadSchedule.cpp
+#include "PayloadSchedule.h"
+#include "ConfigData.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+    // 固定种子，保证同一配置多次运行得到相同的计划表
+    constexpr uint32_t SCHEDULE_SEED = 20240501u;
+}
+
+bool PayloadSchedule::build(const ConfigData& config, size_t min_bytes, std::string& error) {
+    sizes_.clear();
+    mode_ = config.m_sizeMode.empty() ? "fixed" : config.m_sizeMode;
+    min_ = max_ = 0;
+    mean_ = 0.0;
+
+    if (mode_ == "fixed") {
+        return true;
+    }
+
+    const int round_index = config.m_activeLoop;
+    const size_t send_count = static_cast<size_t>(std::max(config.m_sendCount[round_index], 1));
+    const size_t length = std::min(send_count, MAX_LENGTH);
+    const uint32_t lo = static_cast<uint32_t>(std::max<size_t>(config.m_minSize[round_index], min_bytes));
+    const uint32_t hi = static_cast<uint32_t>(std::max<size_t>(config.m_maxSize[round_index], lo));
+
+    sizes_.reserve(length);
+    std::mt19937 gen(SCHEDULE_SEED + static_cast<uint32_t>(round_index));
+
+    if (mode_ == "uniform") {
+        std::uniform_int_distribution<uint32_t> dis(lo, hi);
+        for (size_t i = 0; i < length; ++i) {
+            sizes_.push_back(dis(gen));
+        }
+    }
+    else if (mode_ == "sweep") {
+        const uint32_t step = config.m_sizeStep > 0
+            ? static_cast<uint32_t>(config.m_sizeStep)
+            : std::max<uint32_t>(1, (hi - lo) / 64);
+        uint32_t size = lo;
+        for (size_t i = 0; i < length; ++i) {
+            sizes_.push_back(size);
+            size = (hi - size < step) ? lo : size + step;
+        }
+    }
+    else if (mode_ == "file") {
+        std::vector<uint32_t> values;
+        std::vector<double> weights;
+        if (!loadEmpirical(config.m_sizeFile, values, weights, error)) {
+            return false;
+        }
+        for (auto& v : values) {
+            v = std::max<uint32_t>(v, static_cast<uint32_t>(min_bytes));
+        }
+        std::discrete_distribution<size_t> dis(weights.begin(), weights.end());
+        for (size_t i = 0; i < length; ++i) {
+            sizes_.push_back(values[dis(gen)]);
+        }
+    }
+    else {
+        error = "未知的 m_sizeMode: " + mode_;
+        return false;
+    }
+
+    auto [mn, mx] = std::minmax_element(sizes_.begin(), sizes_.end());
+    min_ = *mn;
+    max_ = *mx;
+    double sum = 0.0;
+    for (uint32_t s : sizes_) {
+        sum += s;
+    }
+    mean_ = sum / static_cast<double>(sizes_.size());
+    return true;
+}
+
+size_t PayloadSchedule::upperBound(const ConfigData& config) {
+    const size_t configured = static_cast<size_t>(config.m_maxSize[config.m_activeLoop]);
+    if (config.m_sizeMode != "file") {
+        return configured;
+    }
+
+    std::vector<uint32_t> values;
+    std::vector<double> weights;
+    std::string error;
+    if (!loadEmpirical(config.m_sizeFile, values, weights, error)) {
+        return configured;
+    }
+    return std::max<size_t>(configured, *std::max_element(values.begin(), values.end()));
+}
+
+bool PayloadSchedule::loadEmpirical(const std::string& path, std::vector<uint32_t>& values,
+    std::vector<double>& weights, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "无法打开 payload 分布文件: " + path;
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') continue;
+
+        // 兼容逗号分隔
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+        long long size = 0;
+        double weight = 1.0;
+        if (!(iss >> size) || size <= 0) {
+            error = path + " 第 " + std::to_string(line_no) + " 行格式错误";
+            return false;
+        }
+        iss >> weight;
+        if (weight <= 0.0) continue;
+
+        values.push_back(static_cast<uint32_t>(size));
+        weights.push_back(weight);
+    }
+
+    if (values.empty()) {
+        error = "payload 分布文件为空: " + path;
+        return false;
+    }
+    return true;
+}
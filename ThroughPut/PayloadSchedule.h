@@ -0,0 +1,50 @@
+﻿// PayloadSchedule.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RoundArena.h"
+
+struct ConfigData;
+
+// 发送端变长 payload 计划表：在轮次开始前一次性生成每次 write 的长度，
+// 发送循环只按下标取值，热路径上没有随机数生成与分配。
+// m_sizeMode:
+//   "fixed"   - 保持原行为：本轮只随机一次长度，不生成计划表
+//   "uniform" - [minSize, maxSize] 均匀分布
+//   "sweep"   - 从 minSize 以 m_sizeStep 步进到 maxSize，循环往复
+//   "file"    - 从 m_sizeFile 读取经验分布，每行 "size weight"，# 开头为注释
+class PayloadSchedule {
+public:
+    // 计划表最大长度，超过时循环使用
+    static constexpr size_t MAX_LENGTH = 1u << 20;
+
+    // 为 config 的当前轮次生成计划表；min_bytes 为单个样本的最小长度（需容纳 PacketHeader）
+    bool build(const ConfigData& config, size_t min_bytes, std::string& error);
+
+    bool variable() const { return !sizes_.empty(); }
+    uint32_t sizeAt(size_t index) const { return sizes_[index % sizes_.size()]; }
+
+    size_t length() const { return sizes_.size(); }
+    uint32_t minSize() const { return min_; }
+    uint32_t maxSize() const { return max_; }
+    double meanSize() const { return mean_; }
+    const std::string& mode() const { return mode_; }
+
+    // 当前轮次可能出现的最大样本长度（接收端据此分配缓冲区）
+    static size_t upperBound(const ConfigData& config);
+
+private:
+    static bool loadEmpirical(const std::string& path, std::vector<uint32_t>& values,
+        std::vector<double>& weights, std::string& error);
+
+    // 计划表只在本轮发送期间使用，从轮次 arena 分配（对象须在轮次结束前销毁）
+    std::vector<uint32_t, RoundArenaAllocator<uint32_t>> sizes_;
+    std::string mode_ = "fixed";
+    uint32_t min_ = 0;
+    uint32_t max_ = 0;
+    double mean_ = 0.0;
+};
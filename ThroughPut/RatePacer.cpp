@@ -0,0 +1,114 @@
+﻿// RatePacer.cpp
+#include "RatePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+namespace {
+    // 距截止时间小于该值时改为自旋：Windows 默认定时器精度约 1~15.6ms，
+    // 限速期间用 timeBeginPeriod(1) 把精度提到 1ms，sleep 仍可能多睡 1~2ms，因此留 2ms 自旋窗口
+#ifdef _WIN32
+    constexpr std::chrono::microseconds SPIN_THRESHOLD(2000);
+#else
+    constexpr std::chrono::microseconds SPIN_THRESHOLD(200);
+#endif
+}
+
+RatePacer::RatePacer(int burst_count, int delay_us)
+    : enabled_(burst_count > 0 && delay_us > 0)
+    , burst_count_(burst_count)
+    , period_(std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(delay_us)))
+{
+}
+
+RatePacer::~RatePacer() {
+    releaseTimerResolution();
+}
+
+void RatePacer::start() {
+#ifdef _WIN32
+    // 只在限速时提高系统定时器精度（影响全系统功耗），finish 或析构时恢复
+    if (enabled_ && !timer_period_set_) {
+        timer_period_set_ = (timeBeginPeriod(1) == TIMERR_NOERROR);
+    }
+#endif
+    start_time_ = Clock::now();
+    next_deadline_ = start_time_;
+    in_burst_ = 0;
+    sent_ = 0;
+    bursts_ = 0;
+    late_bursts_ = 0;
+    error_sum_us_ = 0.0;
+    error_max_us_ = 0.0;
+}
+
+void RatePacer::onSent() {
+    ++sent_;
+    if (!enabled_ || ++in_burst_ < burst_count_) {
+        return;
+    }
+
+    // 一个批次发送完毕，等待下一批次的计划时刻
+    in_burst_ = 0;
+    ++bursts_;
+    next_deadline_ += period_;
+
+    Clock::time_point now = Clock::now();
+    if (now >= next_deadline_) {
+        // 已落后于计划：不等待，下一批次立即发送以追回进度
+        ++late_bursts_;
+    }
+    else {
+        waitUntil(next_deadline_);
+        now = Clock::now();
+    }
+
+    const double error_us = std::chrono::duration<double, std::micro>(now - next_deadline_).count();
+    error_sum_us_ += error_us;
+    error_max_us_ = (std::max)(error_max_us_, error_us);
+}
+
+PacingReport RatePacer::finish() {
+    releaseTimerResolution();
+
+    PacingReport report;
+    report.enabled = enabled_;
+    report.bursts = bursts_;
+    report.late_bursts = late_bursts_;
+
+    const double elapsed_s = std::chrono::duration<double>(Clock::now() - start_time_).count();
+    report.achieved_rate_pps = elapsed_s > 0.0 ? static_cast<double>(sent_) / elapsed_s : 0.0;
+
+    if (enabled_) {
+        const double period_s = std::chrono::duration<double>(period_).count();
+        report.target_rate_pps = static_cast<double>(burst_count_) / period_s;
+        report.mean_error_us = bursts_ > 0 ? error_sum_us_ / static_cast<double>(bursts_) : 0.0;
+        report.max_error_us = error_max_us_;
+    }
+    return report;
+}
+
+void RatePacer::releaseTimerResolution() {
+#ifdef _WIN32
+    if (timer_period_set_) {
+        timeEndPeriod(1);
+        timer_period_set_ = false;
+    }
+#endif
+}
+
+void RatePacer::waitUntil(Clock::time_point deadline) {
+    Clock::time_point now = Clock::now();
+    if (deadline - now > SPIN_THRESHOLD) {
+        std::this_thread::sleep_until(deadline - SPIN_THRESHOLD);
+    }
+    while (Clock::now() < deadline) {
+        // 自旋等待
+    }
+}
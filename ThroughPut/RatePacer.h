@@ -0,0 +1,58 @@
+﻿// RatePacer.h
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// 单轮限速发送的统计结果
+struct PacingReport {
+    bool enabled = false;           // 本轮是否限速（m_sendDelay / m_sendDelayCount 均 > 0）
+    double target_rate_pps = 0.0;   // 目标速率 = m_sendDelayCount / m_sendDelay
+    double achieved_rate_pps = 0.0; // 实际速率 = 已发送条数 / 发送耗时
+    uint64_t bursts = 0;            // 完成的突发批次数
+    uint64_t late_bursts = 0;       // 到达截止时间时已落后于计划的批次数（未等待直接发送）
+    double mean_error_us = 0.0;     // 批次实际起始时刻相对计划时刻的平均偏差
+    double max_error_us = 0.0;      // 最大偏差
+};
+
+// 发送限速器：每发送 burst_count 条后等待到下一个计划时刻（间隔 delay_us）。
+// 计划时刻按 start + k * delay 绝对计算，单次唤醒偏差不会累积成漂移；
+// 等待采用"先 sleep 到截止前一小段，再自旋到截止时刻"的混合方式，兼顾精度与 CPU 占用；
+// Windows 下限速期间（start 到 finish）把系统定时器精度提到 1ms。
+class RatePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RatePacer(int burst_count, int delay_us);
+    ~RatePacer();
+    RatePacer(const RatePacer&) = delete;
+    RatePacer& operator=(const RatePacer&) = delete;
+
+    bool enabled() const { return enabled_; }
+
+    // 发送循环开始前调用，作为计划起点
+    void start();
+    // 每成功发送一条后调用（写失败不计入），批次结束时阻塞到下一个计划时刻
+    void onSent();
+    // 发送循环结束后调用，生成统计
+    PacingReport finish();
+
+private:
+    void waitUntil(Clock::time_point deadline);
+    void releaseTimerResolution();
+
+    bool enabled_ = false;
+    int burst_count_ = 0;
+    Clock::duration period_{};
+    bool timer_period_set_ = false;   // 已调用 timeBeginPeriod(1)，待恢复
+
+    Clock::time_point start_time_{};
+    Clock::time_point next_deadline_{};
+    int in_burst_ = 0;
+    uint64_t sent_ = 0;
+
+    uint64_t bursts_ = 0;
+    uint64_t late_bursts_ = 0;
+    double error_sum_us_ = 0.0;
+    double error_max_us_ = 0.0;
+};
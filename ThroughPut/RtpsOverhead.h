@@ -0,0 +1,40 @@
+﻿// RtpsOverhead.h
+#pragma once
+
+#include <cstdint>
+
+// 按 RTPS over UDP/IPv4 估算单个样本在 IP 层占用的字节数（不含以太网帧头/前导码）。
+// 假设每个 RTPS 报文只携带一个样本（不做 batch），超过单个 UDP 数据报的样本按 DATA_FRAG 分片，
+// UDP 数据报再按 MTU 1500 做 IP 分片。仅用于估算线上带宽，与实际协议栈行为可能有少量出入。
+namespace RtpsOverhead {
+    constexpr uint64_t RTPS_HEADER = 20;             // "RTPS" + 版本 + vendorId + guidPrefix
+    constexpr uint64_t INFO_TS = 12;                 // 时间戳子报文
+    constexpr uint64_t DATA_SUBMESSAGE = 24;         // DATA 子报文头（readerId/writerId/writerSN 等）
+    constexpr uint64_t DATA_FRAG_SUBMESSAGE = 36;    // DATA_FRAG 子报文头
+    constexpr uint64_t SERIALIZED_PAYLOAD_HEADER = 4; // CDR 封装头
+    constexpr uint64_t SEQUENCE_LENGTH = 4;          // sequence<octet> 长度前缀
+    constexpr uint64_t UDP_HEADER = 8;
+    constexpr uint64_t IPV4_HEADER = 20;
+    constexpr uint64_t IP_MTU_PAYLOAD = 1480;        // MTU 1500 - IPv4 头
+    constexpr uint64_t MAX_UDP_PAYLOAD = 65507;
+
+    inline uint64_t estimateWireBytes(uint64_t payload_bytes) {
+        const uint64_t data = payload_bytes + SERIALIZED_PAYLOAD_HEADER + SEQUENCE_LENGTH;
+        const uint64_t single = RTPS_HEADER + INFO_TS + DATA_SUBMESSAGE + data;
+
+        uint64_t datagrams = 1;
+        uint64_t rtps_bytes = single;
+        if (single > MAX_UDP_PAYLOAD) {
+            // 分片：每个数据报都带 RTPS 头 + INFO_TS + DATA_FRAG
+            const uint64_t per_datagram_overhead = RTPS_HEADER + INFO_TS + DATA_FRAG_SUBMESSAGE;
+            const uint64_t fragment_size = MAX_UDP_PAYLOAD - per_datagram_overhead;
+            datagrams = (data + fragment_size - 1) / fragment_size;
+            rtps_bytes = data + datagrams * per_datagram_overhead;
+        }
+
+        // 每个数据报加 UDP 头，再按 MTU 拆成若干 IP 包，每个 IP 包一个 IPv4 头
+        const uint64_t udp_bytes = rtps_bytes + datagrams * UDP_HEADER;
+        const uint64_t ip_packets = (udp_bytes + IP_MTU_PAYLOAD - 1) / IP_MTU_PAYLOAD;
+        return udp_bytes + ip_packets * IPV4_HEADER;
+    }
+}
@@ -0,0 +1,92 @@
+﻿// SequenceTracker.cpp
+#include "SequenceTracker.h"
+
+#include <algorithm>
+
+void SequenceTracker::reset() {
+    bits_.fill(0);
+    head_ = 0;
+    tail_ = 0;
+    current_gap_ = 0;
+    report_ = SequenceReport{};
+}
+
+void SequenceTracker::onSequence(uint64_t seq) {
+    ++report_.received;
+
+    if (seq >= head_) {
+        // 新的最大序列号，中间跳过的序列号暂记为"未到"，等滑出窗口再结算
+        advanceTo(seq + 1);
+        setBit(seq);
+        ++report_.unique;
+        return;
+    }
+
+    if (seq < tail_) {
+        // 已滑出窗口（此前已按丢失结算），只能记为过期
+        ++report_.stale;
+        return;
+    }
+
+    if (testBit(seq)) {
+        ++report_.duplicates;
+    }
+    else {
+        setBit(seq);
+        ++report_.unique;
+        ++report_.out_of_order;
+    }
+}
+
+SequenceReport SequenceTracker::finish(uint64_t expected_count) {
+    // 尾部未到的序列号同样计入丢失
+    const uint64_t end = std::max(head_, expected_count);
+    advanceTo(end);
+    while (tail_ < head_) {
+        if (testBit(tail_)) {
+            settleReceived();
+        }
+        else {
+            settleMissing(1);
+        }
+        clearBit(tail_);
+        ++tail_;
+    }
+    return report_;
+}
+
+void SequenceTracker::advanceTo(uint64_t new_head) {
+    if (new_head <= head_) return;
+
+    // 需要滑出窗口的下界
+    const uint64_t new_tail = new_head > WINDOW_BITS ? new_head - WINDOW_BITS : 0;
+
+    // 超过窗口长度的跳跃：整个旧窗口先逐个结算，其余部分批量计为丢失
+    const uint64_t settle_end = std::min(new_tail, head_);
+    while (tail_ < settle_end) {
+        if (testBit(tail_)) {
+            settleReceived();
+        }
+        else {
+            settleMissing(1);
+        }
+        clearBit(tail_);
+        ++tail_;
+    }
+    if (tail_ < new_tail) {
+        // [head_, new_tail) 从未进入窗口，全部丢失
+        settleMissing(new_tail - tail_);
+        tail_ = new_tail;
+    }
+    head_ = new_head;
+}
+
+void SequenceTracker::settleMissing(uint64_t count) {
+    report_.lost += count;
+    current_gap_ += count;
+    report_.longest_gap = std::max(report_.longest_gap, current_gap_);
+}
+
+void SequenceTracker::settleReceived() {
+    current_gap_ = 0;
+}
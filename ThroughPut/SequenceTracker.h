@@ -0,0 +1,57 @@
+﻿// SequenceTracker.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// 单轮序列号检测结果
+struct SequenceReport {
+    uint64_t received = 0;       // 收到的数据包（含重复）
+    uint64_t unique = 0;         // 去重后的有效包
+    uint64_t lost = 0;           // 最终未收到的序列号个数
+    uint64_t duplicates = 0;     // 重复收到
+    uint64_t out_of_order = 0;   // 晚于更大序列号到达（乱序，但仍在窗口内被补上）
+    uint64_t stale = 0;          // 到达时已滑出窗口，无法判断重复与否（已计入 lost）
+    uint64_t longest_gap = 0;    // 最长连续丢包数
+};
+
+// 接收端序列号跟踪：固定大小的位图滑动窗口，不做任何逐样本分配。
+// 窗口覆盖 [head - WINDOW_BITS, head)，head 为已见最大序列号 + 1；
+// 序列号滑出窗口时若仍未收到则判定为丢失，因此乱序深度在 WINDOW_BITS 以内的包不会被误判。
+// 仅允许单个线程（Listener 线程）调用 onSequence，finish 须在接收结束后调用。
+class SequenceTracker {
+public:
+    static constexpr uint64_t WINDOW_BITS = 8192;
+
+    SequenceTracker() { reset(); }
+
+    void reset();
+    void onSequence(uint64_t seq);
+    // 结束本轮：把窗口内及 [head, expected_count) 范围内未收到的序列号结算为丢失
+    SequenceReport finish(uint64_t expected_count);
+
+private:
+    static constexpr uint64_t WORD_BITS = 64;
+    static constexpr uint64_t WORD_COUNT = WINDOW_BITS / WORD_BITS;
+
+    bool testBit(uint64_t seq) const {
+        return (bits_[(seq % WINDOW_BITS) / WORD_BITS] >> (seq % WORD_BITS)) & 1ULL;
+    }
+    void setBit(uint64_t seq) {
+        bits_[(seq % WINDOW_BITS) / WORD_BITS] |= (1ULL << (seq % WORD_BITS));
+    }
+    void clearBit(uint64_t seq) {
+        bits_[(seq % WINDOW_BITS) / WORD_BITS] &= ~(1ULL << (seq % WORD_BITS));
+    }
+
+    // 把 head_ 推进到 new_head，滑出窗口的序列号逐个结算
+    void advanceTo(uint64_t new_head);
+    void settleMissing(uint64_t count);
+    void settleReceived();
+
+    std::array<uint64_t, WORD_COUNT> bits_{};
+    uint64_t head_ = 0;          // 已见最大序列号 + 1
+    uint64_t tail_ = 0;          // 窗口内最小的未结算序列号
+    uint64_t current_gap_ = 0;   // 正在累计的连续丢包长度
+    SequenceReport report_;
+};
@@ -1,21 +1,65 @@
 #pragma once
 #include "SysMetrics.h"
+#include "LatencyHistogram.h"
+#include "RatePacer.h"
+#include "SequenceTracker.h"
+#include "ThroughputSeries.h"
 
+#include <memory>
+#include <utility>
 #include <vector>
 
+// ն»
+struct ReceiveSummary {
+    uint64_t packets = 0;
+    uint64_t payload_bytes = 0;   // ʵյ payload ֽ
+    uint64_t wire_bytes = 0;      //  IP ֽڣ RTPS/UDP/IP ͷ
+    double duration_s = 0.0;      // һ
+    double pps = 0.0;
+    double goodput_mbps = 0.0;
+    double wire_mbps = 0.0;
+};
+
 struct TestRoundResult {
     int round_index;              // ڼ
     SysMetrics start_metrics;     // ʼʱԴ״̬
     SysMetrics end_metrics;       // ʱԴ״̬
+    // ʱӷֲnsʱӲԵķͶ䣻Уڻص/临ʱͰ
+    std::shared_ptr<const LatencyHistogram> latency;
+    PacingReport pacing;          // Ͷͳƣ²ԵķͶ
+    SequenceReport sequence;      // кŶ/ظ/ͳƣ²ԵĽն
+
+    // ¼ڼ䰴̶ԴʱУCPU /  / GloMemPool / ȱҳ
+    ResourceSeries samples;
 
-    // ѡм㣨ڻͼ
-    std::vector<SysMetrics> samples;
+    // ն˷У samples ͬΪʱУ䳤ȼ throughput_stats.interval_ms
+    // ͨ samples.start_steady_ns  throughput_stats.start_steady_ns 룩
+    std::vector<IntervalSample> throughput_series;
+    IntervalStats throughput_stats;
+    ReceiveSummary receive;       // նֻ
+    // Ӳܼm_perfCounters ʱͶΪѭնΪ Listener ߳壨thread_wide
+    PerfCounterReport perf;
 
     // --- 洢ֲԵ CPU ʹʷ¼ ---
     // ʹ float ܱ double ʡһЩڴ棬ȶ CPU % ͨҲ㹻
     std::vector<float> cpu_usage_history;
     // ---  ---
 
+    // ʱÿݵ CPU ʷcpu_usage_history еĽʹУ
+    CpuHistory cpu_history;
+    //  MetricsReport::addResult  cpu_usage_history 
+    CpuUsageStats cpu_stats;
+
+    // һֵ CPU ʷͬ cpu_usage_history
+    void attachCpuHistory(CpuHistory history) {
+        cpu_usage_history.clear();
+        cpu_usage_history.reserve(history.samples.size());
+        for (const auto& sample : history.samples) {
+            cpu_usage_history.push_back(sample.process_percent);
+        }
+        cpu_history = std::move(history);
+    }
+
     // ע⣺캯Ҫȷڹʱȷʼ cpu_usage_history
     // ƳʹþۺϳʼĬϹ캯ȻֶֶΡ
     // ǰ캯ûгʼ samples  cpu_usage_history
@@ -5,6 +5,11 @@
 #include "ResourceUtilization.h"
 #include "TestRoundResult.h"
 #include "SysMetrics.h"
+#include "RatePacer.h"
+#include "SequenceTracker.h"
+#include "ThroughputSeries.h"
+#include "RtpsOverhead.h"
+#include "PayloadSchedule.h"
 
 #include "ZRDDSDataWriter.h"
 #include "ZRDDSDataReader.h"
@@ -22,6 +27,10 @@ struct PacketHeader {
     uint8_t  packet_type;
 };
 
+// DDSManager 侧 PacketHeader（sequence + timestamp + packet_type）的大小，
+// Listener 依赖其中的 packet_type 判断结束包，变长样本不能短于它
+constexpr size_t MIN_PACKET_BYTES = 24;
+
 // ========================
 // 内部类：WriterListener
 // ========================
@@ -141,6 +150,32 @@ bool Throughput_Bytes::waitForReaderMatch() {
     }
 }
 
+void Throughput_Bytes::logPacingReport(const PacingReport& report) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "发送速率 | 实际: " << report.achieved_rate_pps << " pps";
+    if (report.enabled) {
+        oss << " | 目标: " << report.target_rate_pps << " pps"
+            << " | 批次: " << report.bursts
+            << " | 落后批次: " << report.late_bursts
+            << " | 调度偏差 avg: " << report.mean_error_us << " us"
+            << " | max: " << report.max_error_us << " us";
+    }
+    Logger::getInstance().logAndPrint(oss.str());
+}
+
+void Throughput_Bytes::logPayloadSchedule(const PayloadSchedule& schedule) {
+    if (!schedule.variable()) return;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "变长 payload | 模式: " << schedule.mode()
+        << " | 计划表: " << schedule.length() << " 项"
+        << " | 长度: [" << schedule.minSize() << ", " << schedule.maxSize() << "]"
+        << " | 平均: " << schedule.meanSize() << " 字节";
+    Logger::getInstance().logAndPrint(oss.str());
+}
+
 // ========================
 // runPublisher - 发送逻辑
 // ========================
@@ -158,6 +193,9 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
     const int maxSize = config.m_maxSize[round_index];
     const int sendCount = config.m_sendCount[round_index];
     const int sendPrintGap = config.m_sendPrintGap[round_index];
+    // 未配置 m_sendDelay 时数组会被补齐为默认值，此时不限速
+    const int sendDelayUs = config.has_m_sendDelay ? config.m_sendDelay[round_index] : 0;
+    const int sendDelayCount = config.m_sendDelayCount[round_index];
 
     if (!waitForWriterMatch()) {
         Logger::getInstance().logAndPrint("Throughput_Bytes: 等待 Subscriber 匹配超时");
@@ -173,10 +211,21 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
     resUtil.initialize();
     SysMetrics start_metrics = resUtil.collectCurrentMetrics();
 
+    // 变长模式：预先生成长度计划表，buffer 按计划表中的最大长度分配
+    PayloadSchedule schedule;
+    std::string schedule_error;
+    if (!schedule.build(config, MIN_PACKET_BYTES, schedule_error)) {
+        Logger::getInstance().logAndPrint("Throughput_Bytes: " + schedule_error);
+        return -1;
+    }
+    logPayloadSchedule(schedule);
+    const int allocMin = schedule.variable() ? static_cast<int>(schedule.maxSize()) : minSize;
+    const int allocMax = schedule.variable() ? static_cast<int>(schedule.maxSize()) : maxSize;
+
     DDS::Bytes sample;
 
     // 准备测试数据（只准备一次，后续复用 buffer）
-    if (!ddsManager_.prepareBytesData(sample, minSize, maxSize, 0, 0)) {
+    if (!ddsManager_.prepareBytesData(sample, allocMin, allocMax, 0, 0)) {
         Logger::getInstance().logAndPrint("Throughput_Bytes: 准备测试数据失败");
         return -1;
     }
@@ -185,27 +234,78 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
     uint8_t* buffer = sample.value.get_contiguous_buffer();
     if (!buffer) {
         Logger::getInstance().error("Throughput_Bytes: 内存 buffer 为空");
+        ddsManager_.cleanupBytesData(sample);
         return -1;
     }
 
+    // 样本环：每次 write 轮换到下一个独立 buffer，而不是反复改写同一块内存
+    bool use_ring = false;
+    if (config.m_sampleRingSize != 0) {
+        use_ring = ddsManager_.prepareBytesRing(config.m_sampleRingSize, static_cast<int>(sample.value.length()));
+        if (!use_ring) {
+            Logger::getInstance().logAndPrint("Throughput_Bytes: 样本环准备失败，退回单 buffer 复用");
+        }
+    }
+
+    RatePacer pacer(sendDelayCount, sendDelayUs);
+    if (pacer.enabled()) {
+        Logger::getInstance().logAndPrint(
+            "限速发送：每 " + std::to_string(sendDelayCount) + " 条等待 " + std::to_string(sendDelayUs) + " us"
+        );
+    }
+
+    // 发送准备全部成功后才开始资源记录，上面的提前返回不会留下未停止的记录
+    resUtil.registerCurrentThread("send-loop");
+    resUtil.start_cpu_recording();
+
+    // 硬件计数只覆盖发送主循环（本线程）
+    PerfCounters send_perf;
+    if (config.m_perfCounters && send_perf.open()) {
+        send_perf.start();
+    }
+
     // === 发送主循环 ===
+    pacer.start();
     for (int j = 0; j < sendCount; ++j) {
-        *reinterpret_cast<uint32_t*>(buffer) = j;
+        DDS::Bytes& out = use_ring ? ddsManager_.ringSample(static_cast<size_t>(j)) : sample;
+        uint8_t* out_buffer = use_ring ? out.value.get_contiguous_buffer() : buffer;
+
+        *reinterpret_cast<uint32_t*>(out_buffer) = j;
+        if (schedule.variable()) {
+            out.value._length = schedule.sizeAt(static_cast<size_t>(j));
+        }
 
-        DDS::ReturnCode_t ret = writer->write(sample, DDS_HANDLE_NIL_NATIVE);
+        DDS::ReturnCode_t ret = writer->write(out, DDS_HANDLE_NIL_NATIVE);
         if (ret == DDS::RETCODE_OK) {
             static int cnt = 0;
             if (++cnt % sendPrintGap == 0) {
-                Logger::getInstance().logAndPrint("已发送 " + std::to_string(cnt) + " 条");
+                LOG_BIN_PRINT("已发送 {} 条", cnt);
             }
+            // 只有成功写出的样本占用限速配额
+            pacer.onSent();
         }
         else {
             Logger::getInstance().error("Write failed: " + std::to_string(ret));
         }
     }
+    send_perf.stop();
+    const PacingReport pacing = pacer.finish();
+    logPacingReport(pacing);
 
     // 等待所有数据被确认
-    writer->wait_for_acknowledgments({ 10, 0 });  // 10秒超时
+    const DDS::ReturnCode_t ack_ret = writer->wait_for_acknowledgments({ 10, 0 });  // 10秒超时
+
+    // 确认后中间件不再引用环中的样本；未确认时保留到 shutdown 删除实体之后再释放
+    if (use_ring) {
+        if (ack_ret == DDS::RETCODE_OK) {
+            ddsManager_.cleanupBytesRing();
+        }
+        else {
+            Logger::getInstance().logAndPrint(
+                "Throughput_Bytes: 等待确认未完成 (ret=" + std::to_string(ack_ret) + ")，样本环暂不释放"
+            );
+        }
+    }
 
     // === 发送结束包（标记本轮结束）===
     // === 发送结束包 ===
@@ -217,6 +317,8 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
         }
         else {
             Logger::getInstance().logAndPrint("错误：结束包长度为 0");
+            ddsManager_.cleanupBytesData(sample);
+            resUtil.stop_cpu_recording_and_get_samples();
             return -1;
         }
         for (int k = 0; k < 3; ++k) {
@@ -228,15 +330,44 @@ int Throughput_Bytes::runPublisher(const ConfigData& config) {
     ddsManager_.cleanupBytesData(sample);
 
     // 收集资源使用情况
+    CpuHistory cpu_history = resUtil.stop_cpu_recording_and_get_samples();
     SysMetrics end_metrics = resUtil.collectCurrentMetrics();
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics });
+        TestRoundResult result{ round_index + 1, start_metrics, end_metrics };
+        result.attachCpuHistory(std::move(cpu_history));
+        result.samples = resUtil.take_resource_series();
+        result.pacing = pacing;
+        if (config.m_perfCounters) {
+            result.perf = send_perf.report(static_cast<uint64_t>(sendCount));
+        }
+        result_callback_(result);
     }
 
     Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮发送完成");
     return 0;
 }
 
+// ========================
+// prepareRound - 重置本轮接收状态
+// ========================
+// 必须在 DDSManager::initialize 之前调用：reader 创建后 Listener 线程随时可能回调，
+// 此后再重置会与 onDataReceived 竞争，且把已收到的序号计为丢失
+void Throughput_Bytes::prepareRound(const ConfigData& config) {
+    receivedCount_.store(0);
+    receivedBytes_.store(0);
+    wireBytes_.store(0);
+    roundFinished_.store(false);
+    seq_tracker_.reset();
+    series_.reset();
+    {
+        std::lock_guard<std::mutex> lock(time_mutex_);
+        first_packet_time_ = std::chrono::steady_clock::time_point();
+        end_packet_time_ = std::chrono::steady_clock::time_point();
+        listener_perf_.close();
+        perf_enabled_ = config.m_perfCounters;
+    }
+}
+
 // ========================
 // runSubscriber - 接收逻辑
 // ========================
@@ -262,10 +393,10 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
     auto& resUtil = ResourceUtilization::instance();
     resUtil.initialize();
     SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+    resUtil.registerCurrentThread("main");
+    resUtil.start_cpu_recording();
 
-    // 重置状态
-    receivedCount_.store(0);
-    roundFinished_.store(false);
+    // 接收状态已由 prepareRound 在 DDSManager::initialize 之前重置
 
     // 用于计时（由回调设置）
     std::chrono::steady_clock::time_point start_time;
@@ -297,11 +428,12 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
 
     // === 计算吞吐量 ===
     int received = receivedCount_.load();
+    const uint64_t received_bytes = receivedBytes_.load();
+    const uint64_t wire_bytes = wireBytes_.load();
     double duration_seconds = 0.0;
     double throughput_pps = 0.0;
     double throughput_mbps = 0.0;
-
-    int avg_packet_size = config.m_minSize[round_index];
+    double wire_mbps = 0.0;
 
     if (start_time.time_since_epoch().count() != 0 &&
         end_time.time_since_epoch().count() != 0 &&
@@ -313,21 +445,58 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
         throughput_pps = duration_seconds > 0 ? static_cast<double>(received) / duration_seconds : 0.0;
 
         if (duration_seconds > 1e-9) {
-            throughput_mbps = (static_cast<double>(avg_packet_size) *
-                static_cast<double>(received) * 8.0 /
+            // 按实际收到的 payload 字节计算，min/max 不同时同样准确
+            throughput_mbps = (static_cast<double>(received_bytes) * 8.0 /
+                (1024.0 * 1024.0)) / duration_seconds;
+            wire_mbps = (static_cast<double>(wire_bytes) * 8.0 /
                 (1024.0 * 1024.0)) / duration_seconds;
         }
     }
 
     // === 计算丢包数和丢包率 ===
     int expected = config.m_sendCount[round_index];
-    int lost = expected - received;
+    // 按序列号结算真实丢包（重复包不会抵消丢包）
+    const SequenceReport seq_report = seq_tracker_.finish(static_cast<uint64_t>(expected));
+    int lost = static_cast<int>(seq_report.lost);
+
+    // === 分区间吞吐 ===
+    IntervalStats interval_stats;
+    std::vector<IntervalSample> series = series_.finish(interval_stats);
     double lossRate = expected > 0 ? (double)lost / expected * 100.0 : 0.0;
 
+    // === Listener 线程硬件计数 ===
+    PerfCounterReport perf;
+    {
+        std::lock_guard<std::mutex> lock(time_mutex_);
+        listener_perf_.stop();
+        perf = listener_perf_.report(static_cast<uint64_t>(received));
+        // 计数器在首包时打开后一直运行到本轮结束（逐样本启停的 ioctl 开销会远超回调本身），
+        // 因此包含中间件在回调之外的收包与调度开销
+        perf.thread_wide = true;
+        listener_perf_.close();
+    }
+
     // === 上报资源使用 ===
+    CpuHistory cpu_history = resUtil.stop_cpu_recording_and_get_samples();
     SysMetrics end_metrics = resUtil.collectCurrentMetrics();
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics });
+        TestRoundResult result{ round_index + 1, start_metrics, end_metrics };
+        result.attachCpuHistory(std::move(cpu_history));
+        result.samples = resUtil.take_resource_series();
+        result.sequence = seq_report;
+        if (config.m_perfCounters) {
+            result.perf = perf;
+        }
+        result.throughput_series = series;
+        result.throughput_stats = interval_stats;
+        result.receive.packets = static_cast<uint64_t>(received);
+        result.receive.payload_bytes = received_bytes;
+        result.receive.wire_bytes = wire_bytes;
+        result.receive.duration_s = duration_seconds;
+        result.receive.pps = throughput_pps;
+        result.receive.goodput_mbps = throughput_mbps;
+        result.receive.wire_mbps = wire_mbps;
+        result_callback_(result);
     }
 
     // === 输出结果 ===
@@ -337,28 +506,78 @@ int Throughput_Bytes::runSubscriber(const ConfigData& config) {
         << "接收: " << received << " 包 | "
         << "丢包: " << lost << " 包 | "
         << "丢包率: " << lossRate << "% | "
+        << "重复: " << seq_report.duplicates << " | "
+        << "乱序: " << seq_report.out_of_order << " | "
+        << "最长连续丢包: " << seq_report.longest_gap << " | "
         << "耗时: " << duration_seconds * 1000.0 << " ms | "
         << "吞吐: " << throughput_pps << " pps | "
-        << "带宽: " << throughput_mbps << " Mbps";
+        << "有效带宽: " << throughput_mbps << " Mbps | "
+        << "线上带宽(估算): " << wire_mbps << " Mbps";
 
     Logger::getInstance().logAndPrint(oss.str());
+    logIntervalSeries(series, interval_stats);
 
     return 0;
 }
 
+void Throughput_Bytes::logIntervalSeries(const std::vector<IntervalSample>& series, const IntervalStats& stats) {
+    if (stats.intervals == 0) return;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "区间吞吐 (" << stats.interval_ms << " ms x " << stats.intervals << ") | "
+        << "pps min/avg/max: " << stats.min_pps << " / " << stats.mean_pps << " / " << stats.max_pps
+        << " | 标准差: " << stats.stddev_pps
+        << " | Mbps min/max: " << stats.min_mbps << " / " << stats.max_mbps
+        << " | 标准差: " << stats.stddev_mbps;
+    if (stats.dropped_intervals > 0) {
+        oss << " | 最早 " << stats.dropped_intervals << " 个区间已被覆盖";
+    }
+    Logger::getInstance().logAndPrint(oss.str());
+
+    // 完整序列只写日志文件
+    for (const auto& s : series) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2)
+            << "[Interval] t=" << s.offset_ms << "ms dur=" << s.duration_ms << "ms"
+            << " packets=" << s.packets << " bytes=" << s.bytes
+            << " pps=" << s.pps << " mbps=" << s.mbps;
+        Logger::getInstance().log(line.str());
+    }
+}
+
 // ========================
 // 回调函数
 // ========================
 
-void Throughput_Bytes::onDataReceived(const DDS::Bytes& /*sample*/, const DDS::SampleInfo& info) {
+void Throughput_Bytes::onDataReceived(const DDS::Bytes& sample, const DDS::SampleInfo& info) {
     if (!info.valid_data) return;
 
+    // 解析 PacketHeader::sequence（位于 payload 起始处）
+    if (sample.value.length() >= sizeof(uint32_t)) {
+        const uint8_t* buffer = sample.value.get_contiguous_buffer();
+        if (buffer) {
+            seq_tracker_.onSequence(*reinterpret_cast<const uint32_t*>(buffer));
+        }
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t length = sample.value.length();
+    series_.record(length, now);
+    // 只有 Listener 线程写入，relaxed 原子累加不存在竞争
+    receivedBytes_.fetch_add(length, std::memory_order_relaxed);
+    wireBytes_.fetch_add(RtpsOverhead::estimateWireBytes(length), std::memory_order_relaxed);
+
     int64_t count = receivedCount_.fetch_add(1, std::memory_order_relaxed) + 1;
 
     // 记录第一个包的时间
     if (count == 1) {
+        ResourceUtilization::instance().registerCurrentThread("dds-listener");
         std::lock_guard<std::mutex> lock(time_mutex_);
-        first_packet_time_ = std::chrono::steady_clock::now();
+        first_packet_time_ = now;
+        if (perf_enabled_ && listener_perf_.open()) {
+            listener_perf_.start();
+        }
         Logger::getInstance().logAndPrint("收到第一个数据包，开始计时...");
     }
 }
@@ -1,5 +1,10 @@
 ﻿// Throughput_ZeroCopyBytes.cpp
 #include "Throughput_ZeroCopyBytes.h" // <--- 确保包含头文件
+#include "RatePacer.h"
+#include "SequenceTracker.h"
+#include "ThroughputSeries.h"
+#include "RtpsOverhead.h"
+#include "PayloadSchedule.h"
 
 #include "ZRDDSDataWriter.h"
 #include "ZRDDSDataReader.h"
@@ -11,6 +16,7 @@
 #include <sstream>
 #include <iomanip>
 #include <mutex>
+#include <algorithm>
 
 using namespace DDS;
 
@@ -21,6 +27,10 @@ struct PacketHeader {
     uint8_t  packet_type;  // 0=数据包, 1=结束包
 };
 
+// DDSManager 侧 PacketHeader（sequence + timestamp + packet_type）的大小，
+// Listener 依赖其中的 packet_type 判断结束包，变长样本不能短于它
+constexpr size_t MIN_PACKET_BYTES = 24;
+
 // ========================
 // 内部类：WriterListener (专用于 ZeroCopy)
 // ========================
@@ -127,6 +137,32 @@ bool Throughput_ZeroCopyBytes::waitForReaderMatch() {
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 }
+void Throughput_ZeroCopyBytes::logPacingReport(const PacingReport& report) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "发送速率 | 实际: " << report.achieved_rate_pps << " pps";
+    if (report.enabled) {
+        oss << " | 目标: " << report.target_rate_pps << " pps"
+            << " | 批次: " << report.bursts
+            << " | 落后批次: " << report.late_bursts
+            << " | 调度偏差 avg: " << report.mean_error_us << " us"
+            << " | max: " << report.max_error_us << " us";
+    }
+    Logger::getInstance().logAndPrint(oss.str());
+}
+
+void Throughput_ZeroCopyBytes::logPayloadSchedule(const PayloadSchedule& schedule) {
+    if (!schedule.variable()) return;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "变长 payload | 模式: " << schedule.mode()
+        << " | 计划表: " << schedule.length() << " 项"
+        << " | 长度: [" << schedule.minSize() << ", " << schedule.maxSize() << "]"
+        << " | 平均: " << schedule.meanSize() << " 字节";
+    Logger::getInstance().logAndPrint(oss.str());
+}
+
 // ========================
 // runPublisher - 发送逻辑（零拷贝专用）
 // ========================
@@ -144,11 +180,24 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
     const int maxSize = config.m_maxSize[round_index];
     const int sendCount = config.m_sendCount[round_index];
     const int sendPrintGap = config.m_sendPrintGap[round_index];
+    // 未配置 m_sendDelay 时数组会被补齐为默认值，此时不限速
+    const int sendDelayUs = config.has_m_sendDelay ? config.m_sendDelay[round_index] : 0;
+    const int sendDelayCount = config.m_sendDelayCount[round_index];
+
+    // 变长模式：预先生成长度计划表，缓冲区按计划表中的最大长度分配
+    PayloadSchedule schedule;
+    std::string schedule_error;
+    if (!schedule.build(config, MIN_PACKET_BYTES, schedule_error)) {
+        Logger::getInstance().logAndPrint("Throughput_ZeroCopyBytes: " + schedule_error);
+        return -1;
+    }
+    logPayloadSchedule(schedule);
+    const int allocSize = schedule.variable() ? static_cast<int>(schedule.maxSize()) : minSize;
 
     // === 确保 Zero-Copy 缓冲区大小匹配当前轮次数据尺寸 ===
-    if (!ddsManager_.ensureBufferSize(static_cast<size_t>(minSize))) {
+    if (!ddsManager_.ensureBufferSize(static_cast<size_t>(allocSize))) {
         Logger::getInstance().error(
-            "Throughput_ZeroCopyBytes: 无法为大小 " + std::to_string(minSize) +
+            "Throughput_ZeroCopyBytes: 无法为大小 " + std::to_string(allocSize) +
             " 字节分配 Zero-Copy 缓冲区"
         );
         return -1;
@@ -171,7 +220,7 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
     DDS::ZeroCopyBytes sample;
 
     // 准备主数据样本（会使用新分配的 global_buffer）
-    if (!ddsManager_.prepareZeroCopyData(sample, minSize, 0)) {
+    if (!ddsManager_.prepareZeroCopyData(sample, allocSize, 0)) {
         Logger::getInstance().logAndPrint("Throughput_ZeroCopyBytes: 准备 ZeroCopy 测试数据失败");
         return -1;
     }
@@ -182,26 +231,90 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
         return -1;
     }
 
+    // 缓冲池：每次 write 使用独立 buffer，在途 buffer 回收前不会被改写
+    bool use_pool = false;
+    if (config.m_zeroCopyPoolSize != 0) {
+        use_pool = ddsManager_.prepareBufferPool(config.m_zeroCopyPoolSize, static_cast<size_t>(allocSize));
+        if (!use_pool) {
+            Logger::getInstance().logAndPrint("Throughput_ZeroCopyBytes: 缓冲池准备失败，退回单 buffer 复用");
+        }
+    }
+
+    RatePacer pacer(sendDelayCount, sendDelayUs);
+    if (pacer.enabled()) {
+        Logger::getInstance().logAndPrint(
+            "限速发送：每 " + std::to_string(sendDelayCount) + " 条等待 " + std::to_string(sendDelayUs) + " us"
+        );
+    }
+
+    // 发送准备全部成功后才开始资源记录，上面的提前返回不会留下未停止的记录
+    resUtil.registerCurrentThread("send-loop");
+    resUtil.start_cpu_recording();
+
+    // 硬件计数只覆盖发送主循环（本线程）
+    PerfCounters send_perf;
+    if (config.m_perfCounters && send_perf.open()) {
+        send_perf.start();
+    }
+
     // === 发送主循环 ===
+    bool aborted = false;
+    pacer.start();
     for (int j = 0; j < sendCount; ++j) {
-        // 更新序列号
-        *reinterpret_cast<uint32_t*>(userBuffer) = static_cast<uint32_t>(j);
+        const int length = schedule.variable() ? static_cast<int>(schedule.sizeAt(static_cast<size_t>(j))) : allocSize;
+        if (use_pool) {
+            if (!ddsManager_.acquirePooledSample(sample, length, static_cast<uint32_t>(j))) {
+                // 跳过该序号会被接收端计为丢包，直接中止本轮
+                Logger::getInstance().error(
+                    "Throughput_ZeroCopyBytes: 缓冲池无可用 buffer, 第 " + std::to_string(round_index + 1) +
+                    " 轮在 seq=" + std::to_string(j) + " 处中止"
+                );
+                aborted = true;
+                break;
+            }
+        }
+        else {
+            // 更新序列号
+            *reinterpret_cast<uint32_t*>(userBuffer) = static_cast<uint32_t>(j);
+            sample.userLength = length;
+        }
 
         DDS::ReturnCode_t ret = writer->write(sample, DDS_HANDLE_NIL_NATIVE);
+        if (use_pool) {
+            ddsManager_.commitPooledSample(ret == DDS::RETCODE_OK);
+        }
         if (ret == DDS::RETCODE_OK) {
             static int cnt = 0;
             if (++cnt % sendPrintGap == 0) {
-                Logger::getInstance().logAndPrint("已发送 " + std::to_string(cnt) + " 条");
+                LOG_BIN_PRINT("已发送 {} 条", cnt);
             }
+            // 只有成功写出的样本占用限速配额
+            pacer.onSent();
         }
         else {
             Logger::getInstance().error("Write failed: " + std::to_string(ret));
         }
     }
+    send_perf.stop();
+    const PacingReport pacing = pacer.finish();
+    logPacingReport(pacing);
 
     // 等待所有数据被确认
     DDS::Duration_t timeout = { 10, 0 };
-    writer->wait_for_acknowledgments(timeout);
+    const DDS::ReturnCode_t ack_ret = writer->wait_for_acknowledgments(timeout);
+
+    // 确认后中间件不再引用池中的 buffer；未确认时保留到 shutdown 删除实体之后释放
+    if (use_pool) {
+        if (ack_ret == DDS::RETCODE_OK) {
+            ddsManager_.recycleBufferPool();
+            ddsManager_.cleanupBufferPool();
+        }
+        else {
+            Logger::getInstance().logAndPrint(
+                "Throughput_ZeroCopyBytes: 等待确认未完成 (ret=" + std::to_string(ack_ret) + ")，缓冲池暂不释放"
+            );
+        }
+    }
 
     // === 发送结束包（标记本轮结束）===
     ddsManager_.prepareEndZeroCopyData(sample);
@@ -212,15 +325,48 @@ int Throughput_ZeroCopyBytes::runPublisher(const ConfigData& config) {
     }
 
     // 收集资源使用情况
+    CpuHistory cpu_history = resUtil.stop_cpu_recording_and_get_samples();
     SysMetrics end_metrics = resUtil.collectCurrentMetrics();
+    if (aborted) {
+        Logger::getInstance().error("第 " + std::to_string(round_index + 1) + " 轮发送中止 (ZeroCopy)");
+        return -1;
+    }
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics }); // <--- 此处应能正常工作
+        TestRoundResult result{ round_index + 1, start_metrics, end_metrics };
+        result.attachCpuHistory(std::move(cpu_history));
+        result.samples = resUtil.take_resource_series();
+        result.pacing = pacing;
+        if (config.m_perfCounters) {
+            result.perf = send_perf.report(static_cast<uint64_t>(sendCount));
+        }
+        result_callback_(result);
     }
 
     Logger::getInstance().logAndPrint("第 " + std::to_string(round_index + 1) + " 轮发送完成 (ZeroCopy)");
     return 0;
 }
 
+// ========================
+// prepareRound - 重置本轮接收状态
+// ========================
+// 必须在 DDSManager::initialize 之前调用：reader 创建后 Listener 线程随时可能回调，
+// 此后再重置会与 onDataReceived 竞争，且把已收到的序号计为丢失
+void Throughput_ZeroCopyBytes::prepareRound(const ConfigData& config) {
+    receivedCount_.store(0);
+    receivedBytes_.store(0);
+    wireBytes_.store(0);
+    roundFinished_.store(false);
+    seq_tracker_.reset();
+    series_.reset();
+    {
+        std::lock_guard<std::mutex> lock(time_mutex_);
+        first_packet_time_ = std::chrono::steady_clock::time_point();
+        end_packet_time_ = std::chrono::steady_clock::time_point();
+        listener_perf_.close();
+        perf_enabled_ = config.m_perfCounters;
+    }
+}
+
 // ========================
 // runSubscriber - 接收逻辑（零拷贝专用）
 // ========================
@@ -236,10 +382,10 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
 
     const int round_index = config.m_activeLoop;
     const int expected = config.m_sendCount[round_index];
-    const int avg_packet_size = config.m_minSize[round_index];  // 假设 min == max
+    const int max_packet_size = static_cast<int>(PayloadSchedule::upperBound(config));
 
-    // === 动态调整接收端缓冲区大小 ===
-    if (!ddsManager_.ensureBufferSize(static_cast<size_t>(avg_packet_size))) {
+    // === 动态调整接收端缓冲区大小（按最大样本分配）===
+    if (!ddsManager_.ensureBufferSize(static_cast<size_t>(max_packet_size))) {
         Logger::getInstance().error(
             "Throughput_ZeroCopyBytes: Subscriber 无法分配足够大的 Zero-Copy 缓冲区"
         );
@@ -256,16 +402,10 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
     auto& resUtil = ResourceUtilization::instance();
     resUtil.initialize();
     SysMetrics start_metrics = resUtil.collectCurrentMetrics();
+    resUtil.registerCurrentThread("main");
+    resUtil.start_cpu_recording();
 
-    // 重置状态
-    receivedCount_.store(0);
-    roundFinished_.store(false);
-
-    {
-        std::lock_guard<std::mutex> lock(time_mutex_);
-        first_packet_time_ = std::chrono::steady_clock::time_point(); // zero 初始化
-        end_packet_time_ = std::chrono::steady_clock::time_point();
-    }
+    // 接收状态已由 prepareRound 在 DDSManager::initialize 之前重置
 
     // === 阻塞等待测试结束信号 ===
     waitForRoundEnd();  // 内部调用 cv_.wait(...) 直到 onEndOfRound() 触发
@@ -285,9 +425,12 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
 
     // === 计算性能指标 ===
     int received = receivedCount_.load();
+    const uint64_t received_bytes = receivedBytes_.load();
+    const uint64_t wire_bytes = wireBytes_.load();
     double duration_seconds = 0.0;
     double throughput_pps = 0.0;
     double throughput_mbps = 0.0;
+    double wire_mbps = 0.0;
 
     if (start_time.time_since_epoch().count() != 0 &&
         end_time.time_since_epoch().count() != 0 &&
@@ -296,19 +439,56 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
         auto duration = end_time - start_time;
         duration_seconds = std::chrono::duration<double>(duration).count();
         throughput_pps = duration_seconds > 0 ? received / duration_seconds : 0.0;
-        throughput_mbps = (static_cast<double>(avg_packet_size) *
-            static_cast<double>(received) * 8.0 /
-            (1024.0 * 1024.0)) / max(duration_seconds, 1e-9);
+        // 按实际收到的 userLength 累计，min/max 不同时同样准确
+        throughput_mbps = (static_cast<double>(received_bytes) * 8.0 /
+            (1024.0 * 1024.0)) / (std::max)(duration_seconds, 1e-9);
+        wire_mbps = (static_cast<double>(wire_bytes) * 8.0 /
+            (1024.0 * 1024.0)) / (std::max)(duration_seconds, 1e-9);
     }
 
     // === 丢包率 ===
-    int lost = expected - received;
+    // 按序列号结算真实丢包（重复包不会抵消丢包）
+    const SequenceReport seq_report = seq_tracker_.finish(static_cast<uint64_t>(expected));
+    int lost = static_cast<int>(seq_report.lost);
+
+    // === 分区间吞吐 ===
+    IntervalStats interval_stats;
+    std::vector<IntervalSample> series = series_.finish(interval_stats);
     double lossRate = expected > 0 ? static_cast<double>(lost) / expected * 100.0 : 0.0;
 
+    // === Listener 线程硬件计数 ===
+    PerfCounterReport perf;
+    {
+        std::lock_guard<std::mutex> lock(time_mutex_);
+        listener_perf_.stop();
+        perf = listener_perf_.report(static_cast<uint64_t>(received));
+        // 计数器在首包时打开后一直运行到本轮结束（逐样本启停的 ioctl 开销会远超回调本身），
+        // 因此包含中间件在回调之外的收包与调度开销
+        perf.thread_wide = true;
+        listener_perf_.close();
+    }
+
     // === 上报资源使用 ===
+    CpuHistory cpu_history = resUtil.stop_cpu_recording_and_get_samples();
     SysMetrics end_metrics = resUtil.collectCurrentMetrics();
     if (result_callback_) {
-        result_callback_(TestRoundResult{ round_index + 1, start_metrics, end_metrics }); // <--- 此处也应能正常工作
+        TestRoundResult result{ round_index + 1, start_metrics, end_metrics };
+        result.attachCpuHistory(std::move(cpu_history));
+        result.samples = resUtil.take_resource_series();
+        result.sequence = seq_report;
+        if (config.m_perfCounters) {
+            result.perf = perf;
+        }
+        result.throughput_series = series;
+        result.throughput_stats = interval_stats;
+        result.receive.packets = static_cast<uint64_t>(received);
+        result.receive.payload_bytes = received_bytes;
+        result.receive.wire_bytes = wire_bytes;
+        result.receive.duration_s = duration_seconds;
+        result.receive.pps = throughput_pps;
+        result.receive.goodput_mbps = throughput_mbps;
+        result.receive.wire_mbps = wire_mbps;
+        result_callback_(result);
     }
 
     // === 输出结果 ===
@@ -318,28 +498,75 @@ int Throughput_ZeroCopyBytes::runSubscriber(const ConfigData& config) {
         << "接收: " << received << " 包 | "
         << "丢包: " << lost << " 包 | "
         << "丢包率: " << lossRate << "% | "
+        << "重复: " << seq_report.duplicates << " | "
+        << "乱序: " << seq_report.out_of_order << " | "
+        << "最长连续丢包: " << seq_report.longest_gap << " | "
         << "耗时: " << (duration_seconds * 1000.0) << " ms | "
         << "吞吐: " << throughput_pps << " pps | "
-        << "带宽: " << throughput_mbps << " Mbps";
+        << "有效带宽: " << throughput_mbps << " Mbps | "
+        << "线上带宽(估算): " << wire_mbps << " Mbps";
 
     Logger::getInstance().logAndPrint(oss.str());
+    logIntervalSeries(series, interval_stats);
 
     return 0;
 }
 
+void Throughput_ZeroCopyBytes::logIntervalSeries(const std::vector<IntervalSample>& series, const IntervalStats& stats) {
+    if (stats.intervals == 0) return;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "区间吞吐 (" << stats.interval_ms << " ms x " << stats.intervals << ") | "
+        << "pps min/avg/max: " << stats.min_pps << " / " << stats.mean_pps << " / " << stats.max_pps
+        << " | 标准差: " << stats.stddev_pps
+        << " | Mbps min/max: " << stats.min_mbps << " / " << stats.max_mbps
+        << " | 标准差: " << stats.stddev_mbps;
+    if (stats.dropped_intervals > 0) {
+        oss << " | 最早 " << stats.dropped_intervals << " 个区间已被覆盖";
+    }
+    Logger::getInstance().logAndPrint(oss.str());
+
+    // 完整序列只写日志文件
+    for (const auto& s : series) {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2)
+            << "[Interval] t=" << s.offset_ms << "ms dur=" << s.duration_ms << "ms"
+            << " packets=" << s.packets << " bytes=" << s.bytes
+            << " pps=" << s.pps << " mbps=" << s.mbps;
+        Logger::getInstance().log(line.str());
+    }
+}
+
 // ========================
 // 回调函数实现（供外部 initialize 时传入）
 // ========================
 
-void Throughput_ZeroCopyBytes::onDataReceived(const DDS_ZeroCopyBytes& /*sample*/, const DDS::SampleInfo& info) {
+void Throughput_ZeroCopyBytes::onDataReceived(const DDS_ZeroCopyBytes& sample, const DDS::SampleInfo& info) {
     if (!info.valid_data) return;
 
+    // 解析 PacketHeader::sequence（位于 userBuffer 起始处）
+    if (sample.userBuffer && sample.userLength >= sizeof(uint32_t)) {
+        seq_tracker_.onSequence(*reinterpret_cast<const uint32_t*>(sample.userBuffer));
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t length = sample.userLength;
+    series_.record(length, now);
+    // 只有 Listener 线程写入，relaxed 原子累加不存在竞争
+    receivedBytes_.fetch_add(length, std::memory_order_relaxed);
+    wireBytes_.fetch_add(RtpsOverhead::estimateWireBytes(length), std::memory_order_relaxed);
+
     int64_t count = receivedCount_.fetch_add(1, std::memory_order_relaxed) + 1;
 
     // 记录第一个包的时间
     if (count == 1) {
+        ResourceUtilization::instance().registerCurrentThread("dds-listener");
         std::lock_guard<std::mutex> lock(time_mutex_);
-        first_packet_time_ = std::chrono::steady_clock::now();
+        first_packet_time_ = now;
+        if (perf_enabled_ && listener_perf_.open()) {
+            listener_perf_.start();
+        }
         Logger::getInstance().logAndPrint("收到第一个数据包，开始计时...");
     }
 }
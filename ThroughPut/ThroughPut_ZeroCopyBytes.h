@@ -9,10 +9,15 @@
 
 #include "DDSManager_ZeroCopyBytes.h"  //  manager 
 
+#include "SequenceTracker.h"
+#include "ThroughputSeries.h"
+#include "PerfCounters.h"
+#include "PayloadSchedule.h"
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <vector>
 
 namespace DDS {
     class DataWriter;
@@ -27,6 +32,8 @@ public:
 
     int runPublisher(const ConfigData& config);
     int runSubscriber(const ConfigData& config);
+    // նˣ DDSManager::initialize ֮ǰñֽ״̬
+    void prepareRound(const ConfigData& config);
 
     bool waitForSubscriberReconnect(const std::chrono::seconds& timeout);
 
@@ -40,6 +47,10 @@ private:
     ResultCallback result_callback_;
 
     std::atomic<int> receivedCount_{ 0 };
+    std::atomic<uint64_t> receivedBytes_{ 0 };  // ʵյ payload ֽ
+    std::atomic<uint64_t> wireBytes_{ 0 };      //  IP ֽڣ RTPS/UDP/IP ͷ
+    SequenceTracker seq_tracker_;  //  Listener ߳д룬ִνȡ
+    ThroughputSeries series_;      // ͬ
     std::atomic<bool> roundFinished_{ false };
     std::mutex mtx_;
     std::condition_variable cv_;
@@ -53,9 +64,16 @@ private:
     void waitForRoundEnd();
     bool waitForWriterMatch();
     bool waitForReaderMatch();
+    void logPacingReport(const PacingReport& report);
+    void logPayloadSchedule(const PayloadSchedule& schedule);
+    void logIntervalSeries(const std::vector<IntervalSample>& series, const IntervalStats& stats);
 
     std::chrono::steady_clock::time_point first_packet_time_;
     std::chrono::steady_clock::time_point end_packet_time_; // յʱ
 
     mutable std::mutex time_mutex_; //  time_point ޸ģ߳̾
+
+    // Listener ص̵߳Ӳһʱڻص߳д򿪣 time_mutex_ 
+    PerfCounters listener_perf_;
+    bool perf_enabled_ = false;
 };
\ No newline at end of file
@@ -0,0 +1,97 @@
+﻿// ThroughputSeries.cpp
+#include "ThroughputSeries.h"
+
+#include <algorithm>
+#include <cmath>
+
+ThroughputSeries::ThroughputSeries(int interval_ms, size_t capacity)
+    : interval_(std::chrono::milliseconds(interval_ms > 0 ? interval_ms : DEFAULT_INTERVAL_MS))
+    , slots_(capacity > 0 ? capacity : DEFAULT_CAPACITY)
+{
+}
+
+void ThroughputSeries::reset() {
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    started_ = false;
+    start_ = Clock::time_point{};
+    last_ = Clock::time_point{};
+    current_index_ = 0;
+}
+
+void ThroughputSeries::advanceTo(uint64_t index) {
+    // 清空新进入的区间（包括中间没有收到任何包的空区间），最多清空一整圈
+    const uint64_t capacity = slots_.size();
+    const uint64_t to_clear = std::min<uint64_t>(index - current_index_, capacity);
+    for (uint64_t i = index - to_clear + 1; i <= index; ++i) {
+        slots_[static_cast<size_t>(i % capacity)] = Slot{};
+    }
+    current_index_ = index;
+}
+
+std::vector<IntervalSample> ThroughputSeries::finish(IntervalStats& stats) const {
+    std::vector<IntervalSample> series;
+    stats = IntervalStats{};
+
+    const double interval_ms = std::chrono::duration<double, std::milli>(interval_).count();
+    stats.interval_ms = interval_ms;
+    if (!started_) {
+        return series;
+    }
+    stats.start_steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start_.time_since_epoch()).count();
+
+    const uint64_t capacity = slots_.size();
+    const uint64_t total = current_index_ + 1;
+    const uint64_t first = total > capacity ? total - capacity : 0;
+    stats.dropped_intervals = first;
+
+    series.reserve(static_cast<size_t>(total - first));
+    for (uint64_t i = first; i < total; ++i) {
+        const Slot& slot = slots_[static_cast<size_t>(i % capacity)];
+
+        IntervalSample s;
+        s.offset_ms = static_cast<double>(i) * interval_ms;
+        s.duration_ms = interval_ms;
+        if (i == current_index_) {
+            // 最后一个区间只统计到最后一个包
+            s.duration_ms = std::chrono::duration<double, std::milli>(last_ - start_).count() - s.offset_ms;
+        }
+        s.packets = slot.packets;
+        s.bytes = slot.bytes;
+        if (s.duration_ms > 0.0) {
+            s.pps = static_cast<double>(s.packets) * 1000.0 / s.duration_ms;
+            s.mbps = (static_cast<double>(s.bytes) * 8.0 / (1024.0 * 1024.0)) * 1000.0 / s.duration_ms;
+        }
+        series.push_back(s);
+    }
+
+    // 波动统计只看完整区间；只有一个区间时退化为使用它
+    const size_t full = series.size() > 1 ? series.size() - 1 : series.size();
+    if (full == 0) {
+        return series;
+    }
+
+    double sum_pps = 0.0, sum_mbps = 0.0;
+    stats.min_pps = stats.max_pps = series[0].pps;
+    stats.min_mbps = stats.max_mbps = series[0].mbps;
+    for (size_t i = 0; i < full; ++i) {
+        const IntervalSample& s = series[i];
+        sum_pps += s.pps;
+        sum_mbps += s.mbps;
+        stats.min_pps = std::min(stats.min_pps, s.pps);
+        stats.max_pps = std::max(stats.max_pps, s.pps);
+        stats.min_mbps = std::min(stats.min_mbps, s.mbps);
+        stats.max_mbps = std::max(stats.max_mbps, s.mbps);
+    }
+    stats.intervals = full;
+    stats.mean_pps = sum_pps / full;
+    const double mean_mbps = sum_mbps / full;
+
+    double var_pps = 0.0, var_mbps = 0.0;
+    for (size_t i = 0; i < full; ++i) {
+        var_pps += (series[i].pps - stats.mean_pps) * (series[i].pps - stats.mean_pps);
+        var_mbps += (series[i].mbps - mean_mbps) * (series[i].mbps - mean_mbps);
+    }
+    stats.stddev_pps = std::sqrt(var_pps / full);
+    stats.stddev_mbps = std::sqrt(var_mbps / full);
+    return series;
+}
@@ -0,0 +1,79 @@
+﻿// ThroughputSeries.h
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 单个统计区间的吞吐
+struct IntervalSample {
+    double offset_ms = 0.0;   // 区间起点（相对本轮第一个包）
+    double duration_ms = 0.0; // 区间长度（最后一个区间可能不满）
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    double pps = 0.0;
+    double mbps = 0.0;
+};
+
+// 区间吞吐的波动统计（不含最后一个不完整区间）
+struct IntervalStats {
+    double interval_ms = 0.0;
+    int64_t start_steady_ns = 0;    // 第一个包的时刻（steady_clock），用于与资源时间序列对齐
+    size_t intervals = 0;
+    uint64_t dropped_intervals = 0; // 环形缓冲区溢出而被覆盖的最早区间数
+    double min_pps = 0.0;
+    double max_pps = 0.0;
+    double mean_pps = 0.0;
+    double stddev_pps = 0.0;
+    double min_mbps = 0.0;
+    double max_mbps = 0.0;
+    double stddev_mbps = 0.0;
+};
+
+// 接收端分区间吞吐采样：以第一个包为起点，按固定间隔把包数与字节数累加到预分配的环形缓冲区。
+// record() 不分配内存、不加锁，只允许 Listener 线程调用；finish() 在轮次结束后调用。
+class ThroughputSeries {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int DEFAULT_INTERVAL_MS = 100;
+    static constexpr size_t DEFAULT_CAPACITY = 6000;  // 100ms * 6000 = 10 分钟
+
+    explicit ThroughputSeries(int interval_ms = DEFAULT_INTERVAL_MS, size_t capacity = DEFAULT_CAPACITY);
+
+    void reset();
+
+    inline void record(uint64_t bytes, Clock::time_point now) {
+        if (!started_) {
+            started_ = true;
+            start_ = now;
+        }
+        const uint64_t index = static_cast<uint64_t>((now - start_) / interval_);
+        if (index != current_index_) {
+            advanceTo(index);
+        }
+        Slot& slot = slots_[static_cast<size_t>(current_index_ % slots_.size())];
+        ++slot.packets;
+        slot.bytes += bytes;
+        last_ = now;
+    }
+
+    // 导出区间序列（按时间顺序）并计算波动统计
+    std::vector<IntervalSample> finish(IntervalStats& stats) const;
+
+private:
+    struct Slot {
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+    };
+
+    void advanceTo(uint64_t index);
+
+    Clock::duration interval_;
+    std::vector<Slot> slots_;         // 构造时一次性分配
+    bool started_ = false;
+    Clock::time_point start_{};
+    Clock::time_point last_{};
+    uint64_t current_index_ = 0;
+};